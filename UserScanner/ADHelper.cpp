@@ -1,15 +1,39 @@
 #include "ADHelper.h"
 #include "LDAPQuery.h"
+#include "HostCache.h"
+#include "Tracer.h"
+#ifdef _WIN32
 #include <windows.h>
 #include <sddl.h>
+#endif
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
+#include <unordered_set>
+#include <cwctype>
+
+namespace {
+
+    // Names per OR filter; keeps each search well below server filter and result limits
+    const size_t kNamesPerQuery = 200;
+
+    // Upper bound on the filter length of one batched search
+    const size_t kMaxFilterLength = 16 * 1024;
+
+    std::wstring ToLower(std::wstring text) {
+        for (auto& ch : text) {
+            ch = static_cast<wchar_t>(std::towlower(ch));
+        }
+        return text;
+    }
+}
 
 // Constructor
 ADHelper::ADHelper(const std::wstring& domain, const std::wstring& domainController)
     : m_domain(domain)
     , m_domainController(domainController)
+    , m_hostCache(nullptr)
 {
     m_baseDN = DomainToDN(domain);
     std::wcout << L"[INFO] Active Directory Helper initialized" << std::endl;
@@ -20,7 +44,11 @@ ADHelper::ADHelper(const std::wstring& domain, const std::wstring& domainControl
 
 // Creates LDAP connection
 std::unique_ptr<LDAPQuery> ADHelper::CreateLDAPConnection() {
-    auto ldap = std::make_unique<LDAPQuery>(m_domainController);
+    auto ldap = m_connectionFactory ? m_connectionFactory(m_domainController) :
+        std::make_unique<LDAPQuery>(m_domainController);
+    if (!ldap) {
+        return nullptr;
+    }
 
     if (!ldap->Initialize()) {
         std::wcerr << L"[ERROR] LDAP initialization failed." << std::endl;
@@ -71,6 +99,91 @@ std::vector<ComputerInfo> ADHelper::GetAllComputers() {
     return computers;
 }
 
+// Retrieves the given computers in batched searches
+std::vector<ComputerInfo> ADHelper::GetComputers(const std::vector<std::wstring>& names,
+    std::vector<std::wstring>* notFound) {
+    std::vector<ComputerInfo> computers;
+
+    auto ldap = CreateLDAPConnection();
+    if (!ldap) {
+        return computers;
+    }
+
+    std::vector<std::wstring> attributes = { L"cn", L"dNSHostName", L"operatingSystem" };
+    std::unordered_set<std::wstring> found;
+    std::unordered_set<std::wstring> seenHosts;
+    size_t queries = 0;
+    size_t derivedNames = 0;
+    size_t next = 0;
+
+    while (next < names.size()) {
+        // FQDNs match dNSHostName, anything else the common name
+        std::wstring terms;
+        size_t count = 0;
+
+        while (next < names.size() && count < kNamesPerQuery) {
+            const std::wstring& name = names[next];
+            std::wstring term = (name.find(L'.') != std::wstring::npos ? L"(dNSHostName=" : L"(cn=") +
+                EscapeFilterValue(name) + L")";
+            if (count > 0 && terms.size() + term.size() > kMaxFilterLength) {
+                break;
+            }
+            terms += term;
+            count++;
+            next++;
+        }
+
+        std::wstring filter = L"(&(objectClass=computer)(|" + terms + L"))";
+        queries++;
+
+        if (!ldap->Search(m_baseDN, filter, attributes)) {
+            std::wcerr << L"[ERROR] Computer search failed." << std::endl;
+            return computers;
+        }
+
+        for (const auto& row : ldap->GetEntries(attributes)) {
+            found.insert(ToLower(row[0]));
+            found.insert(ToLower(row[1]));
+
+            // Objects without a DNS name (never registered, or not yet joined)
+            // are connected to by common name in the domain
+            std::wstring hostname = row[1];
+            if (hostname.empty()) {
+                if (row[0].empty()) {
+                    continue;
+                }
+                hostname = row[0] + L"." + m_domain;
+                derivedNames++;
+            }
+            if (!seenHosts.insert(ToLower(hostname)).second) {
+                continue;
+            }
+
+            ComputerInfo info;
+            info.hostname = hostname;
+            info.computerName = ExtractComputerName(hostname, m_domain);
+            info.operatingSystem = row[2].empty() ? L"Unknown" : row[2];
+            computers.push_back(info);
+        }
+    }
+
+    if (notFound) {
+        for (const auto& name : names) {
+            if (!found.count(ToLower(name))) {
+                notFound->push_back(name);
+            }
+        }
+    }
+
+    std::wcout << L"[INFO] " << computers.size() << L" of " << names.size()
+        << L" computers found in " << queries << L" queries." << std::endl;
+    if (derivedNames > 0) {
+        std::wcout << L"[WARNING] " << derivedNames << L" computers have no dNSHostName; "
+            << L"connecting to <cn>." << m_domain << L" instead." << std::endl;
+    }
+    return computers;
+}
+
 // Retrieves the operating system of a specified computer
 std::wstring ADHelper::GetComputerOS(const std::wstring& computerName) {
     auto ldap = CreateLDAPConnection();
@@ -79,7 +192,7 @@ std::wstring ADHelper::GetComputerOS(const std::wstring& computerName) {
     }
 
     // Search for the specific computer
-    std::wstring filter = L"(&(objectClass=computer)(cn=" + computerName + L"))";
+    std::wstring filter = L"(&(objectClass=computer)(cn=" + EscapeFilterValue(computerName) + L"))";
     std::vector<std::wstring> attributes = { L"operatingSystem" };
 
     if (!ldap->Search(m_baseDN, filter, attributes)) {
@@ -95,19 +208,66 @@ std::wstring ADHelper::GetComputerOS(const std::wstring& computerName) {
 }
 
 // Lists active users on a computer
-std::vector<UserInfo> ADHelper::GetLoggedOnUsers(const std::wstring& fullyQualifiedName) {
+std::vector<UserInfo> ADHelper::GetLoggedOnUsers(const std::wstring& fullyQualifiedName, long* errorCode,
+    const std::wstring& address) {
     std::vector<UserInfo> users;
 
+#ifndef _WIN32
+    // Remote registry and SID lookup are only available through the Windows API
+    (void)fullyQualifiedName;
+    (void)address;
+    if (errorCode) {
+        *errorCode = 50; // ERROR_NOT_SUPPORTED
+    }
+    return users;
+#else
+
+    // A pre-resolved address keeps name resolution off this thread; the
+    // name stays the cache key
+    const std::wstring& target = address.empty() ? fullyQualifiedName : address;
+
     // Connect to remote computer's registry
     HKEY hRemoteKey = nullptr;
-    LONG result = RegConnectRegistryW(fullyQualifiedName.c_str(), HKEY_USERS, &hRemoteKey);
+    LONG result = ERROR_SUCCESS;
+    {
+        TraceSpan span("connect", "registry", fullyQualifiedName);
+        result = RegConnectRegistryW(target.c_str(), HKEY_USERS, &hRemoteKey);
+    }
+    if (errorCode) {
+        *errorCode = result;
+    }
 
     if (result != ERROR_SUCCESS) {
         // Silent failure - many computers may be inaccessible
         return users;
     }
 
+    // An unchanged HKEY_USERS (same last-write time and subkey count) has the
+    // same loaded profiles as last time, so the cached users can be reused
+    HostCacheEntry cacheEntry;
+    bool haveKeyInfo = false;
+
+    if (m_hostCache) {
+        TraceSpan span("cache_check", "registry");
+        DWORD subKeyCount = 0;
+        FILETIME lastWriteTime = {};
+
+        if (RegQueryInfoKeyW(hRemoteKey, nullptr, nullptr, nullptr, &subKeyCount,
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &lastWriteTime) == ERROR_SUCCESS) {
+            cacheEntry.lastWriteTime = (static_cast<uint64_t>(lastWriteTime.dwHighDateTime) << 32) |
+                lastWriteTime.dwLowDateTime;
+            cacheEntry.subKeyCount = subKeyCount;
+            haveKeyInfo = true;
+
+            if (m_hostCache->Lookup(fullyQualifiedName, cacheEntry.lastWriteTime, subKeyCount, users)) {
+                RegCloseKey(hRemoteKey);
+                return users;
+            }
+        }
+    }
+
     // Enumerate subkeys
+    TraceSpan enumSpan("enum_keys", "registry", fullyQualifiedName);
     DWORD index = 0;
     wchar_t subKeyName[256];
     DWORD subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
@@ -115,16 +275,21 @@ std::vector<UserInfo> ADHelper::GetLoggedOnUsers(const std::wstring& fullyQualif
     while (RegEnumKeyExW(hRemoteKey, index, subKeyName, &subKeyNameSize,
         nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
 
+        if (haveKeyInfo) {
+            cacheEntry.subKeys.push_back(subKeyName);
+        }
+
         // Convert SID to username
         PSID pSid = nullptr;
         if (ConvertStringSidToSidW(subKeyName, &pSid)) {
+            TraceSpan span("sid_lookup", "registry", subKeyName);
             wchar_t userName[256] = { 0 };
             DWORD userNameSize = sizeof(userName) / sizeof(wchar_t);
             wchar_t domainName[256] = { 0 };
             DWORD domainNameSize = sizeof(domainName) / sizeof(wchar_t);
             SID_NAME_USE sidType;
 
-            if (LookupAccountSidW(fullyQualifiedName.c_str(), pSid,
+            if (LookupAccountSidW(target.c_str(), pSid,
                 userName, &userNameSize,
                 domainName, &domainNameSize,
                 &sidType)) {
@@ -142,7 +307,152 @@ std::vector<UserInfo> ADHelper::GetLoggedOnUsers(const std::wstring& fullyQualif
     }
 
     RegCloseKey(hRemoteKey);
+
+    if (haveKeyInfo) {
+        cacheEntry.users = users;
+        m_hostCache->Store(fullyQualifiedName, std::move(cacheEntry));
+    }
+
     return users;
+#endif
+}
+
+// Lists the SIDs of the profiles loaded on a computer
+std::vector<std::wstring> ADHelper::GetLoadedProfileSids(const std::wstring& fullyQualifiedName, long* errorCode) {
+    std::vector<std::wstring> sids;
+
+#ifndef _WIN32
+    (void)fullyQualifiedName;
+    if (errorCode) {
+        *errorCode = 50; // ERROR_NOT_SUPPORTED
+    }
+    return sids;
+#else
+
+    HKEY hRemoteKey = nullptr;
+    LONG result = ERROR_SUCCESS;
+    {
+        TraceSpan span("connect", "registry", fullyQualifiedName);
+        result = RegConnectRegistryW(fullyQualifiedName.c_str(), HKEY_USERS, &hRemoteKey);
+    }
+    if (errorCode) {
+        *errorCode = result;
+    }
+
+    if (result != ERROR_SUCCESS) {
+        return sids;
+    }
+
+    // Subkey names only; nothing is resolved on the remote host
+    DWORD index = 0;
+    wchar_t subKeyName[256];
+    DWORD subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
+
+    while (RegEnumKeyExW(hRemoteKey, index, subKeyName, &subKeyNameSize,
+        nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
+        sids.emplace_back(subKeyName, subKeyNameSize);
+
+        index++;
+        subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
+    }
+
+    RegCloseKey(hRemoteKey);
+    return sids;
+#endif
+}
+
+// Resolves an account to its SID
+bool ADHelper::ResolveAccount(const std::wstring& account, UserInfo& info) {
+    bool isSid = account.size() > 4 && (account.compare(0, 4, L"S-1-") == 0 || account.compare(0, 4, L"s-1-") == 0);
+
+#ifndef _WIN32
+    // Name lookup needs LookupAccountNameW; SIDs can still be matched directly
+    if (!isSid) {
+        std::wcerr << L"[ERROR] Account names can only be resolved on Windows, give a SID instead: "
+            << account << std::endl;
+        return false;
+    }
+
+    info = UserInfo(account, account, L"");
+    return true;
+#else
+
+    wchar_t userName[256] = { 0 };
+    DWORD userNameSize = sizeof(userName) / sizeof(wchar_t);
+    wchar_t domainName[256] = { 0 };
+    DWORD domainNameSize = sizeof(domainName) / sizeof(wchar_t);
+    SID_NAME_USE sidType;
+
+    if (isSid) {
+        PSID pSid = nullptr;
+        if (!ConvertStringSidToSidW(account.c_str(), &pSid)) {
+            std::wcerr << L"[ERROR] Invalid SID: " << account << std::endl;
+            return false;
+        }
+
+        // A SID that no longer resolves (e.g. a deleted account) can still be searched for
+        wchar_t* sidString = nullptr;
+        if (ConvertSidToStringSidW(pSid, &sidString)) {
+            info.sid = sidString;
+            LocalFree(sidString);
+        }
+        else {
+            info.sid = account;
+        }
+
+        if (LookupAccountSidW(m_domainController.c_str(), pSid,
+            userName, &userNameSize, domainName, &domainNameSize, &sidType)) {
+            info.userName = userName;
+            info.domainName = domainName;
+        }
+        else {
+            info.userName = info.sid;
+            info.domainName.clear();
+        }
+
+        LocalFree(pSid);
+        return true;
+    }
+
+    // First call obtains the SID buffer size
+    DWORD sidSize = 0;
+    domainNameSize = 0;
+    LookupAccountNameW(m_domainController.c_str(), account.c_str(), nullptr, &sidSize,
+        nullptr, &domainNameSize, &sidType);
+
+    std::vector<BYTE> sidBuffer(sidSize > 0 ? sidSize : 1);
+    domainNameSize = sizeof(domainName) / sizeof(wchar_t);
+
+    if (sidSize == 0 || !LookupAccountNameW(m_domainController.c_str(), account.c_str(), sidBuffer.data(), &sidSize,
+        domainName, &domainNameSize, &sidType)) {
+        std::wcerr << L"[ERROR] Account could not be resolved: " << account
+            << L" (error " << GetLastError() << L")" << std::endl;
+        return false;
+    }
+
+    wchar_t* sidString = nullptr;
+    if (!ConvertSidToStringSidW(sidBuffer.data(), &sidString)) {
+        std::wcerr << L"[ERROR] SID conversion failed: " << account << std::endl;
+        return false;
+    }
+    info.sid = sidString;
+    LocalFree(sidString);
+
+    // Report the account the same way GetLoggedOnUsers does
+    userNameSize = sizeof(userName) / sizeof(wchar_t);
+    domainNameSize = sizeof(domainName) / sizeof(wchar_t);
+    if (LookupAccountSidW(m_domainController.c_str(), sidBuffer.data(),
+        userName, &userNameSize, domainName, &domainNameSize, &sidType)) {
+        info.userName = userName;
+        info.domainName = domainName;
+    }
+    else {
+        info.userName = account;
+        info.domainName.clear();
+    }
+
+    return true;
+#endif
 }
 
 // Converts domain name to LDAP DN format
@@ -176,6 +486,22 @@ std::wstring ADHelper::DomainToDN(const std::wstring& domain) {
     return dn;
 }
 
+// Escapes special characters of an LDAP filter value
+std::wstring ADHelper::EscapeFilterValue(const std::wstring& value) {
+    std::wostringstream escaped;
+
+    for (wchar_t ch : value) {
+        if (ch == L'*' || ch == L'(' || ch == L')' || ch == L'\\' || ch == L'\0') {
+            escaped << L'\\' << std::hex << std::setw(2) << std::setfill(L'0') << static_cast<int>(ch);
+        }
+        else {
+            escaped << ch;
+        }
+    }
+
+    return escaped.str();
+}
+
 // Extracts computer name from FQDN
 std::wstring ADHelper::ExtractComputerName(const std::wstring& fqdn, const std::wstring& domain) {
     // Remove domain part
@@ -4,9 +4,11 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 
-// Forward declaration
+// Forward declarations
 class LDAPQuery;
+class HostCache;
 
 /**
  * @struct ComputerInfo
@@ -16,11 +18,18 @@ struct ComputerInfo {
     std::wstring hostname;          // Fully Qualified Computer Name (FQDN)
     std::wstring computerName;      // Short computer name
     std::wstring operatingSystem;   // Operating system
+    std::wstring address;           // Pre-resolved IP address (empty = not resolved)
+    bool nameNotFound = false;      // DNS reported that the name does not exist
 
     ComputerInfo() = default;
     ComputerInfo(const std::wstring& host, const std::wstring& name, const std::wstring& os)
         : hostname(host), computerName(name), operatingSystem(os) {
     }
+
+    // Name or address used to connect to the computer
+    const std::wstring& GetConnectName() const {
+        return address.empty() ? hostname : address;
+    }
 };
 
 /**
@@ -64,6 +73,15 @@ public:
      */
     std::vector<ComputerInfo> GetAllComputers();
 
+    /**
+     * @brief Retrieves the given computers with batched OR-filter searches over one connection
+     * @param names Short computer names or FQDNs
+     * @param notFound Receives the names that matched no computer object, optional
+     * @return List of computer information
+     */
+    std::vector<ComputerInfo> GetComputers(const std::vector<std::wstring>& names,
+        std::vector<std::wstring>* notFound = nullptr);
+
     /**
      * @brief Retrieves the operating system of the specified computer
      * @param computerName Computer name
@@ -74,9 +92,45 @@ public:
     /**
      * @brief Lists active users on a computer (via registry)
      * @param fullyQualifiedName Fully Qualified Computer Name (FQDN)
+     * @param errorCode Receives the registry connection result (0 = success), optional
+     * @param address Pre-resolved address to connect to instead of the name, optional
      * @return List of user information
      */
-    std::vector<UserInfo> GetLoggedOnUsers(const std::wstring& fullyQualifiedName);
+    std::vector<UserInfo> GetLoggedOnUsers(const std::wstring& fullyQualifiedName, long* errorCode = nullptr,
+        const std::wstring& address = L"");
+
+    /**
+     * @brief Lists the SIDs of the profiles loaded on a computer, without resolving them
+     * @param fullyQualifiedName Fully Qualified Computer Name (FQDN)
+     * @param errorCode Receives the registry connection result (0 = success), optional
+     * @return HKEY_USERS subkey names
+     */
+    std::vector<std::wstring> GetLoadedProfileSids(const std::wstring& fullyQualifiedName, long* errorCode = nullptr);
+
+    /**
+     * @brief Resolves an account given as a SID, DOMAIN\user, user@domain or user name
+     * @param account Account to resolve
+     * @param info Receives the SID and, when it can be looked up, the account name
+     * @return True if a SID was obtained
+     */
+    bool ResolveAccount(const std::wstring& account, UserInfo& info);
+
+    /**
+     * @brief Enables reuse of previous results for hosts whose HKEY_USERS key is unchanged
+     * @param cache Host result cache (nullptr to disable); must outlive the scan
+     */
+    void SetHostCache(HostCache* cache) { m_hostCache = cache; }
+
+    /**
+     * @brief Creates the LDAP connections used by the directory queries
+     */
+    using ConnectionFactory = std::function<std::unique_ptr<LDAPQuery>(const std::wstring& domainController)>;
+
+    /**
+     * @brief Replaces the LDAP connection, e.g. with the benchmark directory
+     * @param factory Connection factory (empty = connect to the domain controller)
+     */
+    void SetConnectionFactory(ConnectionFactory factory) { m_connectionFactory = std::move(factory); }
 
     /**
      * @brief Converts a domain name to LDAP DN format
@@ -85,6 +139,13 @@ public:
      */
     static std::wstring DomainToDN(const std::wstring& domain);
 
+    /**
+     * @brief Escapes a value for use in an LDAP search filter (RFC 4515)
+     * @param value Raw value
+     * @return Escaped value
+     */
+    static std::wstring EscapeFilterValue(const std::wstring& value);
+
     /**
      * @brief Extracts the computer name from a FQDN
      * @param fqdn Fully Qualified Computer Name (e.g., "PC1.example.com")
@@ -97,6 +158,8 @@ private:
     std::wstring m_domain;              // Domain name
     std::wstring m_domainController;    // Domain controller
     std::wstring m_baseDN;              // LDAP base DN
+    HostCache* m_hostCache;             // Result cache for rescans (optional)
+    ConnectionFactory m_connectionFactory;  // LDAP connection override (optional)
 
     /**
      * @brief Creates a connection for LDAP queries
@@ -0,0 +1,433 @@
+#include "Benchmark.h"
+#include "ReportGenerator.h"
+#include "CsvEncoder.h"
+#include "Tracer.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cwchar>
+#include <cwctype>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#ifdef _WIN32
+#pragma comment(lib, "psapi.lib")
+#endif
+
+namespace {
+
+    // Operating systems in rough fleet proportions
+    const wchar_t* const kOperatingSystems[] = {
+        L"Windows 10 Enterprise",
+        L"Windows 10 Enterprise",
+        L"Windows 11 Enterprise",
+        L"Windows 11 Enterprise",
+        L"Windows Server 2019 Standard",
+        L"Windows Server 2022 Datacenter",
+    };
+
+    // Error codes reported for failed hosts (ERROR_SEM_TIMEOUT, ERROR_BAD_NETPATH)
+    const long kErrorSemTimeout = 121;
+    const long kErrorBadNetPath = 53;
+
+    // Well-known HKEY_USERS subkeys resolved on every host (.DEFAULT, S-1-5-18/19/20)
+    const int kSystemSubkeys = 3;
+
+    // Domain of the benchmark hosts
+    const wchar_t* const kBenchDomain = L"bench.local";
+
+    // Common name prefix of the generated hosts
+    const wchar_t* const kHostPrefix = L"BENCH-";
+
+    std::wstring MakeComputerName(size_t index) {
+        wchar_t name[32];
+        swprintf(name, sizeof(name) / sizeof(wchar_t), L"BENCH-%06zu", index);
+        return name;
+    }
+
+    std::wstring MakeHostName(size_t index, const std::wstring& domain) {
+        return MakeComputerName(index) + L"." + domain;
+    }
+
+    // Parses the number of a generated host from its name; suffix receives the rest ("" or ".domain")
+    bool ParseHostNumber(const std::wstring& name, size_t& index, std::wstring& suffix) {
+        size_t prefixLength = std::wcslen(kHostPrefix);
+        if (name.size() <= prefixLength) {
+            return false;
+        }
+        for (size_t i = 0; i < prefixLength; ++i) {
+            if (static_cast<wchar_t>(std::towupper(name[i])) != kHostPrefix[i]) {
+                return false;
+            }
+        }
+
+        size_t end = prefixLength;
+        index = 0;
+        while (end < name.size() && std::iswdigit(name[end])) {
+            index = index * 10 + static_cast<size_t>(name[end] - L'0');
+            end++;
+        }
+        suffix = name.substr(end);
+        return end > prefixLength;
+    }
+
+    // Case-insensitive comparison, as LDAP matches names
+    bool EqualsIgnoreCase(const std::wstring& a, const std::wstring& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](wchar_t x, wchar_t y) {
+            return std::towlower(x) == std::towlower(y);
+        });
+    }
+
+    // Address of a host in subnet 10.<subnet / 256>.<subnet % 256>.0/24
+    std::wstring MakeAddress(size_t subnet, size_t host) {
+        return L"10." + std::to_wstring(subnet / 256 % 256) + L"." + std::to_wstring(subnet % 256) +
+            L"." + std::to_wstring(host % 254 + 1);
+    }
+}
+
+// Constructor
+SyntheticDirectory::SyntheticDirectory(const std::wstring& domain, const BenchmarkOptions& options)
+    : LDAPQuery(L"")
+    , m_domain(domain)
+    , m_options(options)
+{
+}
+
+// Answers a computer search from the generated hosts
+bool SyntheticDirectory::Search(const std::wstring& baseDN,
+    const std::wstring& filter,
+    const std::vector<std::wstring>& attributes) {
+    (void)baseDN;
+    (void)attributes;
+    TraceSpan span("ldap_search", "ldap", filter);
+    m_results.clear();
+
+    // Name terms select hosts, as in the batched searches of ADHelper::GetComputers
+    const wchar_t* const terms[] = { L"(cn=", L"(dNSHostName=" };
+    bool hasTerms = false;
+
+    for (const wchar_t* term : terms) {
+        std::wstring key(term);
+        for (size_t pos = filter.find(key); pos != std::wstring::npos; pos = filter.find(key, pos + 1)) {
+            hasTerms = true;
+            size_t valueStart = pos + key.size();
+            size_t valueEnd = filter.find(L')', valueStart);
+            if (valueEnd == std::wstring::npos) {
+                continue;
+            }
+
+            // A common name has no suffix, a DNS name the domain
+            size_t index = 0;
+            std::wstring suffix;
+            bool isDnsName = key != terms[0];
+            if (ParseHostNumber(filter.substr(valueStart, valueEnd - valueStart), index, suffix) &&
+                index < m_options.hostCount &&
+                (isDnsName ? EqualsIgnoreCase(suffix, L"." + m_domain) : suffix.empty())) {
+                m_results.push_back(index);
+            }
+        }
+    }
+
+    // Entries come back once each, in directory order
+    if (hasTerms) {
+        std::sort(m_results.begin(), m_results.end());
+        m_results.erase(std::unique(m_results.begin(), m_results.end()), m_results.end());
+    }
+    else {
+        m_results.resize(m_options.hostCount);
+        for (size_t i = 0; i < m_results.size(); ++i) {
+            m_results[i] = i;
+        }
+    }
+
+    return true;
+}
+
+// Returns all values of an attribute across the matched hosts
+std::vector<std::wstring> SyntheticDirectory::GetAttributeValues(const std::wstring& attributeName) {
+    std::vector<std::wstring> values;
+    values.reserve(m_results.size());
+
+    for (size_t index : m_results) {
+        std::wstring value = GetValue(index, attributeName);
+        if (!value.empty()) {
+            values.push_back(std::move(value));
+        }
+    }
+
+    return values;
+}
+
+// One row per matched host with the value of each attribute
+std::vector<std::vector<std::wstring>> SyntheticDirectory::GetEntries(const std::vector<std::wstring>& attributes) {
+    std::vector<std::vector<std::wstring>> rows;
+    rows.reserve(m_results.size());
+
+    for (size_t index : m_results) {
+        std::vector<std::wstring> row;
+        row.reserve(attributes.size());
+        for (const auto& attribute : attributes) {
+            row.push_back(GetValue(index, attribute));
+        }
+        rows.push_back(std::move(row));
+    }
+
+    return rows;
+}
+
+// Returns the value of an attribute of a generated host
+std::wstring SyntheticDirectory::GetValue(size_t index, const std::wstring& attributeName) const {
+    const size_t osCount = sizeof(kOperatingSystems) / sizeof(kOperatingSystems[0]);
+
+    if (attributeName == L"cn") {
+        return MakeComputerName(index);
+    }
+    if (attributeName == L"dNSHostName") {
+        return MakeHostName(index, m_domain);
+    }
+    if (attributeName == L"operatingSystem") {
+        return kOperatingSystems[(index * 7 + m_options.seed) % osCount];
+    }
+    return L"";
+}
+
+// Constructor
+SimulatedFleet::SimulatedFleet(const BenchmarkOptions& options)
+    : m_options(options)
+    , m_branchPrefix(MakeAddress(0, 0))
+    , m_branchInFlight(0)
+{
+    m_branchPrefix.resize(m_branchPrefix.rfind(L'.') + 1);
+}
+
+// Probes a simulated host
+std::vector<UserInfo> SimulatedFleet::GetLoggedOnUsers(const ComputerInfo& computer, long* errorCode) const {
+    std::vector<UserInfo> users;
+    long result = 0;
+
+    // Per-host generator: results depend only on host name and seed
+    std::mt19937 rng(static_cast<unsigned int>(std::hash<std::wstring>()(computer.hostname)) ^ m_options.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::lognormal_distribution<double> latency(std::log(std::max(m_options.latencyMs, 1)), m_options.latencySpread);
+
+    double outcome = uniform(rng);
+    double connectMs = latency(rng);
+
+    // The branch link is shared: latency grows with the probes it carries, and past four times its capacity it drops them
+    bool onBranch = m_options.branchCapacity > 0 && computer.address.compare(0, m_branchPrefix.size(), m_branchPrefix) == 0;
+    bool dropped = false;
+    if (onBranch) {
+        int inFlight = ++m_branchInFlight;
+        connectMs *= std::max(1.0, static_cast<double>(inFlight) / m_options.branchCapacity);
+        dropped = inFlight > 4 * m_options.branchCapacity;
+    }
+
+    // A share of the hosts that timed out answer when probed again
+    if (outcome < m_options.timeoutRate && uniform(rng) < m_options.recoveryRate) {
+        std::lock_guard<std::mutex> lock(m_timedOutMutex);
+        if (!m_timedOut.insert(computer.hostname).second) {
+            outcome = 1.0;
+        }
+    }
+
+    if (dropped || outcome < m_options.timeoutRate) {
+        TraceSpan span("connect", "registry", computer.hostname);
+        result = kErrorSemTimeout;
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_options.timeoutMs));
+    }
+    else if (outcome < m_options.timeoutRate + m_options.failureRate) {
+        TraceSpan span("connect", "registry", computer.hostname);
+        result = kErrorBadNetPath;
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(connectMs * 1000.0)));
+    }
+
+    if (errorCode) {
+        *errorCode = result;
+    }
+    if (result != 0) {
+        if (onBranch) {
+            --m_branchInFlight;
+        }
+        return users;
+    }
+
+    std::poisson_distribution<int> sessions(m_options.sessionMean);
+    int sessionCount = sessions(rng);
+
+    // Connect and enumerate, then one SID lookup per resolvable subkey
+    {
+        TraceSpan span("connect", "registry", computer.hostname);
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(connectMs * 1000.0)));
+    }
+    {
+        TraceSpan span("enum_keys", "registry", computer.hostname);
+        double lookupMs = static_cast<double>(m_options.resolveMs) * (sessionCount + kSystemSubkeys);
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(lookupMs * 1000.0)));
+    }
+    if (onBranch) {
+        --m_branchInFlight;
+    }
+
+    std::uniform_int_distribution<int> rid(1000, 999999);
+    for (int i = 0; i < sessionCount; ++i) {
+        int userRid = rid(rng);
+        users.emplace_back(L"S-1-5-21-1004336348-1177238915-682003330-" + std::to_wstring(userRid),
+            L"user" + std::to_wstring(userRid),
+            L"BENCH");
+    }
+
+    return users;
+}
+
+// Records one sample
+void LatencyRecorder::Record(double milliseconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples.push_back(milliseconds);
+}
+
+// Returns the given percentile of the recorded samples
+double LatencyRecorder::Percentile(double percentile) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_samples.empty()) {
+        return 0.0;
+    }
+
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * m_samples.size()));
+    rank = std::min(std::max<size_t>(rank, 1), m_samples.size()) - 1;
+
+    std::nth_element(m_samples.begin(), m_samples.begin() + rank, m_samples.end());
+    return m_samples[rank];
+}
+
+// Returns the number of recorded samples
+size_t LatencyRecorder::GetCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples.size();
+}
+
+// Compares row encoding throughput
+bool RunEncodingBenchmark(size_t rowCount) {
+    using Clock = std::chrono::steady_clock;
+
+    struct Row {
+        ComputerInfo computer;
+        UserInfo user;
+    };
+
+    // Data sets: typical ASCII fleet and one with localized OS and user names; every
+    // 16th row has an OS value with a comma, quote, CR or LF, so quoting is compared too
+    const wchar_t* const asciiNames[] = { L"jsmith", L"adm.backup", L"svc_sql" };
+    const wchar_t* const localNames[] = { L"m\u00FCller", L"\u0141ukasz", L"\u0438\u0432\u0430\u043D" };
+    const wchar_t* const localOS = L"Windows 10 Pro f\u00FCr Workstations";
+    const wchar_t* const specialOS[] = {
+        L"Windows Server 2019, Standard", L"Windows \"Insider\" Preview",
+        L"Windows 11 Enterprise\r", L"Windows 10\r\nEnterprise",
+    };
+
+    bool allEqual = true;
+    const double mb = 1024.0 * 1024.0;
+
+    std::wcout << L"[INFO] Encoding benchmark (" << CsvEncoder::GetInstructionSet() << L"), "
+        << rowCount << L" rows per data set" << std::endl;
+
+    for (int dataSet = 0; dataSet < 2; ++dataSet) {
+        bool localized = dataSet == 1;
+        std::vector<Row> rows;
+        rows.reserve(rowCount);
+
+        for (size_t i = 0; i < rowCount; ++i) {
+            Row row;
+            row.computer.hostname = MakeHostName(i, L"corp.example.com");
+            row.computer.operatingSystem = i % 16 == 15 ? specialOS[(i / 16) % 4] :
+                localized ? localOS : kOperatingSystems[i % 6];
+            row.user.sid = L"S-1-5-21-1004336348-1177238915-682003330-" + std::to_wstring(1000 + i);
+            row.user.userName = (localized ? localNames : asciiNames)[i % 3];
+            row.user.domainName = L"CORP";
+            rows.push_back(row);
+        }
+
+        // Reference: build a wide line, escape, then convert
+        std::string reference;
+        auto start = Clock::now();
+        for (const auto& row : rows) {
+            std::wstring line = ReportGenerator::EscapeCSV(row.computer.hostname) + L"," +
+                ReportGenerator::EscapeCSV(row.computer.operatingSystem) + L"," +
+                ReportGenerator::EscapeCSV(row.user.sid) + L"," +
+                L"\"" + row.user.GetFullName() + L"\"" +
+                L",OK\n";
+            reference += ReportGenerator::WStringToUTF8(line);
+        }
+        double referenceSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Kernel: encode straight into a reused buffer
+        std::string encoded;
+        std::string rowBuffer;
+        start = Clock::now();
+        for (const auto& row : rows) {
+            rowBuffer.clear();
+            ReportGenerator::AppendRow(rowBuffer, row.computer, &row.user);
+            encoded += rowBuffer;
+        }
+        double kernelSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        bool equal = reference == encoded;
+        allEqual = allEqual && equal;
+
+        double size = encoded.size() / mb;
+        std::wcout << (localized ? L"  Non-ASCII" : L"  ASCII") << L" rows: reference "
+            << (referenceSeconds > 0 ? size / referenceSeconds : 0.0) << L" MB/s, kernel "
+            << (kernelSeconds > 0 ? size / kernelSeconds : 0.0) << L" MB/s"
+            << (equal ? L"" : L" [OUTPUT MISMATCH]") << std::endl;
+    }
+
+    return allEqual;
+}
+
+// Enumerates the synthetic directory through ADHelper
+std::vector<ComputerInfo> EnumerateSyntheticDirectory(const BenchmarkOptions& options) {
+    ADHelper adHelper(kBenchDomain, L"synthetic");
+    adHelper.SetConnectionFactory([&options](const std::wstring&) {
+        return std::unique_ptr<LDAPQuery>(new SyntheticDirectory(kBenchDomain, options));
+    });
+    std::vector<ComputerInfo> computers = adHelper.GetAllComputers();
+
+    // Directory order follows the OU layout, so each subnet is one contiguous run
+    if (options.subnetCount > 0) {
+        size_t perSubnet = (options.hostCount + options.subnetCount - 1) / options.subnetCount;
+        for (auto& computer : computers) {
+            size_t index = 0;
+            std::wstring suffix;
+            if (ParseHostNumber(computer.computerName, index, suffix)) {
+                computer.address = MakeAddress(index / perSubnet, index % perSubnet);
+            }
+        }
+    }
+
+    return computers;
+}
+
+// Returns the peak resident memory of the process
+uint64_t GetPeakMemoryUsage() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+#else
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // ru_maxrss is reported in kilobytes on Linux
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    }
+#endif
+    return 0;
+}
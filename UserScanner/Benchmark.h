@@ -0,0 +1,159 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "ADHelper.h"
+#include "LDAPQuery.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include <cstdint>
+
+/**
+ * @struct BenchmarkOptions
+ * @brief Shape of the synthetic directory and host fleet
+ */
+struct BenchmarkOptions {
+    size_t hostCount = 10000;       // Computer objects served by the directory
+    int latencyMs = 20;             // Median connect + enumerate latency per host
+    double latencySpread = 0.5;     // Log-normal sigma of the latency (tail width)
+    double failureRate = 0.10;      // Fraction of hosts that refuse the connection
+    double timeoutRate = 0.02;      // Fraction of hosts that only fail after the timeout
+    int timeoutMs = 1000;           // Simulated connection timeout
+    double recoveryRate = 0.5;      // Fraction of timed-out hosts that answer when probed again
+    double sessionMean = 1.5;       // Mean number of user sessions on a reachable host
+    int resolveMs = 1;              // Latency of each SID lookup
+    unsigned int seed = 1;          // Seed for all distributions
+    size_t subnetCount = 0;         // Consecutive hosts share a /24 (0 = no addresses)
+    int branchCapacity = 0;         // Connections the first subnet carries at full speed (0 = unlimited)
+};
+
+/**
+ * @class SyntheticDirectory
+ * @brief In-process stand-in for the LDAP connection of ADHelper
+ *
+ * Answers the computer searches of ADHelper from generated objects, so
+ * enumeration runs the real ADHelper code without a domain. A filter with
+ * (cn=...) or (dNSHostName=...) terms matches those hosts; any other
+ * filter matches every computer.
+ */
+class SyntheticDirectory : public LDAPQuery {
+public:
+    /**
+     * @brief Constructs the directory
+     * @param domain Domain suffix of the generated host names
+     * @param options Fixture settings
+     */
+    SyntheticDirectory(const std::wstring& domain, const BenchmarkOptions& options);
+
+    bool Initialize() override { return true; }
+    bool Bind() override { return true; }
+    bool Search(const std::wstring& baseDN,
+        const std::wstring& filter,
+        const std::vector<std::wstring>& attributes) override;
+
+    std::vector<std::wstring> GetAttributeValues(const std::wstring& attributeName) override;
+    std::vector<std::vector<std::wstring>> GetEntries(const std::vector<std::wstring>& attributes) override;
+    std::wstring GetLastError() const override { return L"No error"; }
+
+private:
+    std::wstring m_domain;          // Domain suffix
+    BenchmarkOptions m_options;     // Fixture settings
+    std::vector<size_t> m_results;  // Host numbers matched by the last search
+
+    /**
+     * @brief Returns the value of an attribute of a generated host ("" if it has none)
+     */
+    std::wstring GetValue(size_t index, const std::wstring& attributeName) const;
+};
+
+/**
+ * @class SimulatedFleet
+ * @brief Simulates the remote registry probe of GetLoggedOnUsers
+ *
+ * Every host gets a deterministic latency, failure mode and session list
+ * derived from its name and the seed, so runs are reproducible regardless
+ * of thread scheduling. The exception is the optional branch office: the
+ * first subnet slows down in proportion to the probes it carries beyond
+ * its capacity and drops connections past four times that. Hosts that time
+ * out may also answer on a later probe, to exercise retries.
+ */
+class SimulatedFleet {
+public:
+    explicit SimulatedFleet(const BenchmarkOptions& options);
+
+    /**
+     * @brief Probes a simulated host (thread-safe, sleeps for the simulated latency)
+     * @param computer Computer to probe
+     * @param errorCode Receives the simulated connection result (0 = success), optional
+     * @return Simulated logged-on users (empty for failed hosts)
+     */
+    std::vector<UserInfo> GetLoggedOnUsers(const ComputerInfo& computer, long* errorCode = nullptr) const;
+
+private:
+    BenchmarkOptions m_options;                 // Fixture settings
+    std::wstring m_branchPrefix;                // Address prefix of the branch subnet
+    mutable std::atomic<int> m_branchInFlight;  // Probes running against the branch
+    mutable std::mutex m_timedOutMutex;         // Protects m_timedOut
+    mutable std::unordered_set<std::wstring> m_timedOut;    // Recoverable hosts that already timed out once
+};
+
+/**
+ * @class LatencyRecorder
+ * @brief Collects per-host latencies and reports percentiles (thread-safe)
+ */
+class LatencyRecorder {
+public:
+    LatencyRecorder() = default;
+
+    /**
+     * @brief Records one sample in milliseconds
+     */
+    void Record(double milliseconds);
+
+    /**
+     * @brief Returns the given percentile (0-100) of the recorded samples
+     */
+    double Percentile(double percentile);
+
+    /**
+     * @brief Returns the number of recorded samples
+     */
+    size_t GetCount();
+
+private:
+    std::mutex m_mutex;                 // Protects the samples
+    std::vector<double> m_samples;      // Recorded latencies
+};
+
+/**
+ * @brief Compares the row encoding of ReportGenerator against the reference conversion
+ *
+ * Encodes the same generated rows with ReportGenerator::AppendRow and with
+ * the reference EscapeCSV + WStringToUTF8 path, once with ASCII-only data and
+ * once with non-ASCII names, checks that both produce identical bytes and
+ * prints the throughput of each.
+ *
+ * @param rowCount Number of rows per data set
+ * @return True if both encodings produced identical output
+ */
+bool RunEncodingBenchmark(size_t rowCount);
+
+/**
+ * @brief Enumerates the synthetic directory through ADHelper::GetAllComputers
+ *
+ * With subnets configured, each host also gets the address of its subnet,
+ * standing in for DnsResolver.
+ *
+ * @param options Fixture settings
+ * @return Computers of the directory
+ */
+std::vector<ComputerInfo> EnumerateSyntheticDirectory(const BenchmarkOptions& options);
+
+/**
+ * @brief Returns the peak resident memory of the process in bytes (0 if unknown)
+ */
+uint64_t GetPeakMemoryUsage();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,142 @@
+#include "CompressedWriter.h"
+#include "Platform.h"
+#include <iostream>
+#include <vector>
+#include <zlib.h>
+
+// Constructor
+CompressedWriter::CompressedWriter(const std::wstring& outputPath, const CompressionOptions& options)
+    : m_outputPath(outputPath)
+    , m_options(options)
+    , m_closing(false)
+    , m_failed(false)
+    , m_bytesIn(0)
+    , m_bytesOut(0)
+{
+    if (m_options.level < 1 || m_options.level > 9) {
+        m_options.level = Z_DEFAULT_COMPRESSION;
+    }
+}
+
+// Destructor
+CompressedWriter::~CompressedWriter() {
+    Close();
+}
+
+// Opens the output file and starts the compression thread
+bool CompressedWriter::Open() {
+    m_outputFile.open(ToNativePath(m_outputPath), std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if (!m_outputFile.is_open()) {
+        std::wcerr << L"[ERROR] Could not open output file: " << m_outputPath << std::endl;
+        return false;
+    }
+
+    m_closing = false;
+    m_failed = false;
+    m_thread = std::thread(&CompressedWriter::CompressionLoop, this);
+    return true;
+}
+
+// Queues a block for compression
+void CompressedWriter::Write(std::string&& block) {
+    if (block.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_queue.size() < MaxQueuedBlocks || m_failed; });
+
+    if (m_failed) {
+        return;
+    }
+
+    m_queue.push_back(std::move(block));
+    m_cv.notify_all();
+}
+
+// Finishes the stream and closes the file
+bool CompressedWriter::Close() {
+    if (!m_thread.joinable()) {
+        return !m_failed;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+
+    m_outputFile.close();
+    return !m_failed;
+}
+
+// Compression thread body
+void CompressedWriter::CompressionLoop() {
+    z_stream stream = {};
+
+    // windowBits 15 + 16 selects the gzip container
+    if (deflateInit2(&stream, m_options.level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        std::wcerr << L"[ERROR] Could not initialize the compressor." << std::endl;
+        m_failed = true;
+        m_cv.notify_all();
+        return;
+    }
+
+    std::vector<unsigned char> output(deflateBound(&stream, static_cast<uLong>(m_options.frameSize)));
+
+    for (;;) {
+        std::string block;
+        bool finish = false;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return !m_queue.empty() || m_closing; });
+
+            if (!m_queue.empty()) {
+                block = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            finish = m_queue.empty() && m_closing;
+        }
+        m_cv.notify_all();
+
+        stream.next_in = reinterpret_cast<Bytef*>(block.empty() ? nullptr : &block[0]);
+        stream.avail_in = static_cast<uInt>(block.size());
+        m_bytesIn += block.size();
+
+        int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+        int ret = Z_OK;
+
+        do {
+            stream.next_out = output.data();
+            stream.avail_out = static_cast<uInt>(output.size());
+
+            ret = deflate(&stream, flush);
+            if (ret == Z_STREAM_ERROR) {
+                break;
+            }
+
+            size_t produced = output.size() - stream.avail_out;
+            if (produced > 0) {
+                m_outputFile.write(reinterpret_cast<const char*>(output.data()), produced);
+                m_bytesOut += produced;
+            }
+        } while (stream.avail_out == 0 || (finish && ret != Z_STREAM_END));
+
+        if (ret == Z_STREAM_ERROR || !m_outputFile) {
+            std::wcerr << L"[ERROR] Compressed write failed: " << m_outputPath << std::endl;
+            m_failed = true;
+            m_cv.notify_all();
+            break;
+        }
+
+        if (finish) {
+            break;
+        }
+    }
+
+    deflateEnd(&stream);
+    m_outputFile.flush();
+}
@@ -0,0 +1,91 @@
+#ifndef COMPRESSEDWRITER_H
+#define COMPRESSEDWRITER_H
+
+#include <string>
+#include <fstream>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct CompressionOptions
+ * @brief Settings for compressed report output
+ */
+struct CompressionOptions {
+    bool enabled = false;               // Write the report as a gzip stream
+    int level = 6;                      // zlib compression level (1-9)
+    size_t frameSize = 1024 * 1024;     // Bytes handed to the compressor per block
+};
+
+/**
+ * @class CompressedWriter
+ * @brief Streams data through a gzip compressor on a background thread
+ *
+ * Callers hand over complete blocks with Write(); the compression thread
+ * deflates them in order and appends the output to the file. At most a few
+ * blocks are queued, so a slow disk or share applies back-pressure instead
+ * of growing memory without bound.
+ */
+class CompressedWriter {
+public:
+    /**
+     * @brief Constructs the writer
+     * @param outputPath Path of the compressed output file
+     * @param options Compression level and block size
+     */
+    CompressedWriter(const std::wstring& outputPath, const CompressionOptions& options);
+
+    ~CompressedWriter();
+
+    CompressedWriter(const CompressedWriter&) = delete;
+    CompressedWriter& operator=(const CompressedWriter&) = delete;
+
+    /**
+     * @brief Opens the output file and starts the compression thread
+     * @return True if successful
+     */
+    bool Open();
+
+    /**
+     * @brief Queues a block for compression (blocks while the queue is full)
+     * @param block Data to compress; ownership is taken
+     */
+    void Write(std::string&& block);
+
+    /**
+     * @brief Compresses the remaining blocks, finishes the stream and closes the file
+     * @return True if all data was written successfully
+     */
+    bool Close();
+
+    /**
+     * @brief Returns byte counters (valid after Close)
+     */
+    uint64_t GetBytesIn() const { return m_bytesIn; }
+    uint64_t GetBytesOut() const { return m_bytesOut; }
+
+private:
+    static const size_t MaxQueuedBlocks = 4;
+
+    std::wstring m_outputPath;          // Output file path
+    CompressionOptions m_options;       // Compression settings
+    std::ofstream m_outputFile;         // Output file stream
+    std::thread m_thread;               // Compression thread
+    std::mutex m_mutex;                 // Protects the block queue
+    std::condition_variable m_cv;       // Signals queue changes
+    std::deque<std::string> m_queue;    // Blocks waiting for compression
+    bool m_closing;                     // No more blocks will be queued
+    std::atomic<bool> m_failed;         // Compression or write error occurred
+    uint64_t m_bytesIn;                 // Uncompressed bytes
+    uint64_t m_bytesOut;                // Compressed bytes
+
+    /**
+     * @brief Compression thread body
+     */
+    void CompressionLoop();
+};
+
+#endif // COMPRESSEDWRITER_H
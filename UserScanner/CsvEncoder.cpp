@@ -0,0 +1,221 @@
+#include "CsvEncoder.h"
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CSVENCODER_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSVENCODER_SSE2 1
+#endif
+
+namespace {
+
+    // Worst-case UTF-8 bytes per wchar_t unit (a UTF-16 unit never needs more than 3)
+    const size_t kMaxBytesPerUnit = sizeof(wchar_t) == 2 ? 3 : 4;
+
+    inline bool IsSpecial(uint32_t ch) {
+        return ch == ',' || ch == '"' || ch == '\n' || ch == '\r';
+    }
+
+#if CSVENCODER_SSE2
+    // Narrows 8 ASCII units starting at src into 8 bytes; returns false if any unit is not ASCII
+    inline bool NarrowASCII8(const wchar_t* src, __m128i& bytes) {
+#if WCHAR_MAX <= 0xFFFF
+        __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i high = _mm_and_si128(units, _mm_set1_epi16(static_cast<short>(0xFF80)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+        bytes = _mm_packus_epi16(units, units);
+#else
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+        __m128i high = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+        __m128i words = _mm_packs_epi32(lo, hi);
+        bytes = _mm_packus_epi16(words, words);
+#endif
+        return true;
+    }
+
+    // Returns true if any of the low 8 bytes is a CSV special character
+    inline bool HasSpecial8(__m128i bytes) {
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(',')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'))),
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r'))));
+        return (_mm_movemask_epi8(hits) & 0xFF) != 0;
+    }
+#endif
+
+#if CSVENCODER_AVX2 && WCHAR_MAX <= 0xFFFF
+    // Narrows 16 ASCII UTF-16 units into 16 bytes; returns false if any unit is not ASCII
+    inline bool NarrowASCII16(const wchar_t* src, __m128i& bytes) {
+        __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        __m256i high = _mm256_and_si256(units, _mm256_set1_epi16(static_cast<short>(0xFF80)));
+        if (!_mm256_testz_si256(high, high)) {
+            return false;
+        }
+        // packus works per 128-bit lane; gather the two 8-byte halves into the low lane
+        __m256i packed = _mm256_packus_epi16(units, units);
+        bytes = _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0xD8));
+        return true;
+    }
+
+    inline bool HasSpecial16(__m128i bytes) {
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(',')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'))),
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r'))));
+        return _mm_movemask_epi8(hits) != 0;
+    }
+#endif
+
+    // Converts the leading ASCII run of src; returns the number of units consumed
+    size_t EncodeASCIIRun(const wchar_t* src, size_t length, char* dst, bool& special) {
+        size_t i = 0;
+
+#if CSVENCODER_AVX2 && WCHAR_MAX <= 0xFFFF
+        for (__m128i bytes; i + 16 <= length && NarrowASCII16(src + i, bytes); i += 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+            special = special || HasSpecial16(bytes);
+        }
+#endif
+#if CSVENCODER_SSE2
+        for (__m128i bytes; i + 8 <= length && NarrowASCII8(src + i, bytes); i += 8) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), bytes);
+            special = special || HasSpecial8(bytes);
+        }
+#endif
+
+        for (; i < length; ++i) {
+            uint32_t ch = static_cast<uint32_t>(src[i]);
+            if (ch >= 0x80) {
+                break;
+            }
+            dst[i] = static_cast<char>(ch);
+            special = special || IsSpecial(ch);
+        }
+
+        return i;
+    }
+
+    // Encodes one non-ASCII code point (one or two units); returns the number of units consumed
+    size_t EncodeCodePoint(const wchar_t* src, size_t length, char*& dst) {
+        uint32_t cp = static_cast<uint32_t>(src[0]);
+        size_t consumed = 1;
+
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint32_t next = length > 1 ? static_cast<uint32_t>(src[1]) : 0;
+            if (next >= 0xDC00 && next <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (next - 0xDC00);
+                consumed = 2;
+            }
+            else {
+                cp = 0xFFFD;
+            }
+        }
+        else if ((cp >= 0xDC00 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            cp = 0xFFFD;
+        }
+
+        if (cp < 0x800) {
+            *dst++ = static_cast<char>(0xC0 | (cp >> 6));
+            *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            *dst++ = static_cast<char>(0xE0 | (cp >> 12));
+            *dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else {
+            *dst++ = static_cast<char>(0xF0 | (cp >> 18));
+            *dst++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+
+        return consumed;
+    }
+}
+
+// Encodes a string to UTF-8 at the end of the buffer
+bool CsvEncoder::Encode(std::string& out, const std::wstring& str) {
+    size_t start = out.size();
+    out.resize(start + str.size() * kMaxBytesPerUnit);
+
+    const wchar_t* src = str.data();
+    size_t length = str.size();
+    char* dst = &out[0] + start;
+    bool special = false;
+
+    size_t i = 0;
+    while (i < length) {
+        size_t ascii = EncodeASCIIRun(src + i, length - i, dst, special);
+        i += ascii;
+        dst += ascii;
+
+        if (i < length) {
+            i += EncodeCodePoint(src + i, length - i, dst);
+        }
+    }
+
+    out.resize(static_cast<size_t>(dst - out.data()));
+    return special;
+}
+
+// Wraps out[start..] in quotes and doubles embedded quotes
+void CsvEncoder::QuoteInPlace(std::string& out, size_t start) {
+    size_t end = out.size();
+
+    // UTF-8 continuation bytes never equal '"', so the encoded bytes can be scanned directly
+    size_t quotes = 0;
+    for (const char* p = out.data() + start;
+        (p = static_cast<const char*>(memchr(p, '"', out.data() + end - p))) != nullptr;
+        ++p) {
+        ++quotes;
+    }
+
+    out.resize(end + quotes + 2);
+    char* base = &out[0];
+    char* dst = base + end + quotes + 1;
+
+    *dst-- = '"';
+    for (size_t src = end; src > start; --src) {
+        char ch = base[src - 1];
+        *dst-- = ch;
+        if (ch == '"') {
+            *dst-- = '"';
+        }
+    }
+    *dst = '"';
+}
+
+// Appends a string as UTF-8
+void CsvEncoder::AppendUTF8(std::string& out, const std::wstring& str) {
+    Encode(out, str);
+}
+
+// Appends a CSV field, quoting only when needed
+void CsvEncoder::AppendField(std::string& out, const std::wstring& str) {
+    size_t start = out.size();
+    if (Encode(out, str)) {
+        QuoteInPlace(out, start);
+    }
+}
+
+// Returns the vector instruction set in use
+const char* CsvEncoder::GetInstructionSet() {
+#if CSVENCODER_AVX2 && WCHAR_MAX <= 0xFFFF
+    return "AVX2";
+#elif CSVENCODER_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
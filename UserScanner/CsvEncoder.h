@@ -0,0 +1,54 @@
+#ifndef CSVENCODER_H
+#define CSVENCODER_H
+
+#include <string>
+
+/**
+ * @class CsvEncoder
+ * @brief Transcodes wide strings to UTF-8 CSV fields, appending to a reusable buffer
+ *
+ * Runs of ASCII characters are converted 8 or 16 characters at a time with
+ * SSE2/AVX2 (when the compiler targets them); other characters go through a
+ * scalar UTF-8 encoder. The special-character check needed for CSV quoting
+ * happens in the same pass, so each field is read only once and nothing is
+ * allocated once the output buffer has grown to its working size.
+ */
+class CsvEncoder {
+public:
+    /**
+     * @brief Appends a string as UTF-8 without any CSV escaping
+     * @param out Output buffer
+     * @param str Wide-character string
+     */
+    static void AppendUTF8(std::string& out, const std::wstring& str);
+
+    /**
+     * @brief Appends a CSV field, quoting it only if it contains a comma, quote or line break
+     * @param out Output buffer
+     * @param str Field value
+     */
+    static void AppendField(std::string& out, const std::wstring& str);
+
+    /**
+     * @brief Wraps the UTF-8 data from start to the end of the buffer in quotes, doubling embedded quotes
+     * @param out Output buffer
+     * @param start Offset where the field begins
+     */
+    static void QuoteInPlace(std::string& out, size_t start);
+
+    /**
+     * @brief Returns the name of the vector instruction set in use ("AVX2", "SSE2" or "scalar")
+     */
+    static const char* GetInstructionSet();
+
+private:
+    /**
+     * @brief Encodes a string to UTF-8 at the end of the buffer
+     * @param out Output buffer
+     * @param str Wide-character string
+     * @return True if the string contains a character that requires CSV quoting
+     */
+    static bool Encode(std::string& out, const std::wstring& str);
+};
+
+#endif // CSVENCODER_H
@@ -0,0 +1,205 @@
+#include "DnsResolver.h"
+#include "HostCache.h"
+#include "Platform.h"
+#include "Tracer.h"
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#endif
+#include <iostream>
+#include <future>
+#include <chrono>
+#include <algorithm>
+
+// Constructor
+DnsResolver::DnsResolver(int threadCount)
+    : m_threadCount(std::max(threadCount, 1))
+    , m_initialized(true)
+    , m_resolved(0)
+    , m_notFound(0)
+    , m_failed(0)
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    m_initialized = (WSAStartup(MAKEWORD(2, 2), &wsaData) == 0);
+    if (!m_initialized) {
+        std::wcerr << L"[ERROR] Winsock initialization failed; names are resolved at connect time." << std::endl;
+    }
+#endif
+}
+
+// Destructor
+DnsResolver::~DnsResolver() {
+#ifdef _WIN32
+    if (m_initialized) {
+        WSACleanup();
+    }
+#endif
+}
+
+// Resolves all host names and annotates the computers
+void DnsResolver::ResolveAll(std::vector<ComputerInfo>& computers) {
+    // Statistics cover this call only; names cached by an earlier call are not counted again
+    m_resolved = 0;
+    m_notFound = 0;
+    m_failed = 0;
+
+    if (!m_initialized || computers.empty()) {
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Each distinct name is resolved once per run
+    std::vector<std::wstring> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& computer : computers) {
+            std::wstring key = HostCache::MakeKey(computer.hostname);
+            if (!key.empty() && m_cache.find(key) == m_cache.end()) {
+                m_cache[key] = ResolveResult();
+                pending.push_back(key);
+            }
+        }
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    auto worker = [this, &pending, &nextIndex]() {
+        for (;;) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= pending.size()) {
+                break;
+            }
+
+            ResolveResult result = ResolveName(pending[index]);
+            switch (result.status) {
+            case ResolveStatus::Resolved: m_resolved++; break;
+            case ResolveStatus::NotFound: m_notFound++; break;
+            case ResolveStatus::Failed: m_failed++; break;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cache[pending[index]] = result;
+        }
+    };
+
+    size_t workers = std::min<size_t>(static_cast<size_t>(m_threadCount), pending.size());
+    std::vector<std::future<void>> futures;
+    for (size_t t = 0; t < workers; ++t) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    // Hand the results to the scan
+    for (auto& computer : computers) {
+        ResolveResult result;
+        if (!Lookup(computer.hostname, result)) {
+            continue;
+        }
+        computer.address = result.status == ResolveStatus::Resolved ? result.address : L"";
+        computer.nameNotFound = result.status == ResolveStatus::NotFound;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::wcout << L"[INFO] DNS: " << pending.size() << L" names in " << seconds << L" s ("
+        << m_resolved << L" resolved, " << m_notFound << L" not found, "
+        << m_failed << L" failed)" << std::endl;
+}
+
+// Returns the cached result for a host name
+bool DnsResolver::Lookup(const std::wstring& hostname, ResolveResult& result) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_cache.find(HostCache::MakeKey(hostname));
+    if (it == m_cache.end()) {
+        return false;
+    }
+
+    result = it->second;
+    return true;
+}
+
+// Resolves one name
+ResolveResult DnsResolver::ResolveName(const std::wstring& hostname) {
+    TraceSpan span("dns", "dns", hostname);
+    ResolveResult result;
+
+#ifdef _WIN32
+    ADDRINFOW hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    ADDRINFOW* addresses = nullptr;
+    int status = GetAddrInfoW(hostname.c_str(), nullptr, &hints, &addresses);
+    if (status != 0) {
+        // WSAHOST_NOT_FOUND is authoritative; WSATRY_AGAIN and others may be transient
+        result.status = (status == WSAHOST_NOT_FOUND || status == WSANO_DATA) ?
+            ResolveStatus::NotFound : ResolveStatus::Failed;
+        return result;
+    }
+
+    const ADDRINFOW* chosen = addresses;
+    for (const ADDRINFOW* entry = addresses; entry != nullptr; entry = entry->ai_next) {
+        if (entry->ai_family == AF_INET) {
+            chosen = entry;
+            break;
+        }
+    }
+
+    wchar_t text[INET6_ADDRSTRLEN] = { 0 };
+    const void* raw = chosen->ai_family == AF_INET ?
+        static_cast<const void*>(&reinterpret_cast<const sockaddr_in*>(chosen->ai_addr)->sin_addr) :
+        static_cast<const void*>(&reinterpret_cast<const sockaddr_in6*>(chosen->ai_addr)->sin6_addr);
+    if (InetNtopW(chosen->ai_family, raw, text, INET6_ADDRSTRLEN)) {
+        result.status = ResolveStatus::Resolved;
+        result.address = text;
+    }
+
+    FreeAddrInfoW(addresses);
+#else
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    int status = getaddrinfo(WideToUTF8(hostname).c_str(), nullptr, &hints, &addresses);
+    if (status != 0) {
+#ifdef EAI_NODATA
+        bool notFound = (status == EAI_NONAME || status == EAI_NODATA);
+#else
+        bool notFound = (status == EAI_NONAME);
+#endif
+        result.status = notFound ? ResolveStatus::NotFound : ResolveStatus::Failed;
+        return result;
+    }
+
+    const addrinfo* chosen = addresses;
+    for (const addrinfo* entry = addresses; entry != nullptr; entry = entry->ai_next) {
+        if (entry->ai_family == AF_INET) {
+            chosen = entry;
+            break;
+        }
+    }
+
+    char text[INET6_ADDRSTRLEN] = { 0 };
+    const void* raw = chosen->ai_family == AF_INET ?
+        static_cast<const void*>(&reinterpret_cast<const sockaddr_in*>(chosen->ai_addr)->sin_addr) :
+        static_cast<const void*>(&reinterpret_cast<const sockaddr_in6*>(chosen->ai_addr)->sin6_addr);
+    if (inet_ntop(chosen->ai_family, raw, text, sizeof(text))) {
+        result.status = ResolveStatus::Resolved;
+        result.address = UTF8ToWide(text);
+    }
+
+    freeaddrinfo(addresses);
+#endif
+
+    return result;
+}
@@ -0,0 +1,93 @@
+#ifndef DNSRESOLVER_H
+#define DNSRESOLVER_H
+
+#include "ADHelper.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+/**
+ * @enum ResolveStatus
+ * @brief Result of resolving one host name
+ */
+enum class ResolveStatus {
+    Resolved,       // Address found
+    NotFound,       // Name does not exist (NXDOMAIN) or has no address
+    Failed          // Resolver error (e.g. timeout); the name is used as is
+};
+
+/**
+ * @struct ResolveResult
+ * @brief Cached resolution of one host name
+ */
+struct ResolveResult {
+    ResolveStatus status = ResolveStatus::Failed;
+    std::wstring address;       // Textual IPv4 (preferred) or IPv6 address
+};
+
+/**
+ * @class DnsResolver
+ * @brief Resolves the host names of a scan up front, in parallel
+ *
+ * Without this stage a stale directory record costs a full resolver
+ * timeout on the probe's critical path. ResolveAll() resolves every
+ * distinct name once with a bounded number of threads, marks names that do
+ * not exist so the scan can skip them and stores the address in
+ * ComputerInfo::address for subnet grouping. Probes still connect by name
+ * (keeping Kerberos), which the system resolver cache then answers.
+ */
+class DnsResolver {
+public:
+    /**
+     * @brief Error code recorded for hosts whose name does not exist (WSAHOST_NOT_FOUND)
+     */
+    static const long kHostNotFound = 11001;
+
+    /**
+     * @brief Constructs the resolver
+     * @param threadCount Maximum number of concurrent lookups
+     */
+    explicit DnsResolver(int threadCount);
+
+    ~DnsResolver();
+
+    DnsResolver(const DnsResolver&) = delete;
+    DnsResolver& operator=(const DnsResolver&) = delete;
+
+    /**
+     * @brief Resolves the host names of all computers and annotates them
+     * @param computers Computers to resolve; address and nameNotFound are set
+     */
+    void ResolveAll(std::vector<ComputerInfo>& computers);
+
+    /**
+     * @brief Returns the cached result for a host name
+     * @return False if the name has not been resolved in this run
+     */
+    bool Lookup(const std::wstring& hostname, ResolveResult& result);
+
+    /**
+     * @brief Returns statistics of the last ResolveAll() call
+     */
+    size_t GetResolvedCount() const { return m_resolved; }
+    size_t GetNotFoundCount() const { return m_notFound; }
+    size_t GetFailedCount() const { return m_failed; }
+
+private:
+    int m_threadCount;                                          // Concurrent lookups
+    bool m_initialized;                                         // Winsock started
+    std::mutex m_mutex;                                         // Protects m_cache
+    std::unordered_map<std::wstring, ResolveResult> m_cache;    // Results by lower-case name
+    std::atomic<size_t> m_resolved;                             // Names with an address (last call)
+    std::atomic<size_t> m_notFound;                             // Names that do not exist (last call)
+    std::atomic<size_t> m_failed;                               // Resolver errors (last call)
+
+    /**
+     * @brief Resolves one name with the system resolver
+     */
+    static ResolveResult ResolveName(const std::wstring& hostname);
+};
+
+#endif // DNSRESOLVER_H
@@ -0,0 +1,151 @@
+#include "Hmac.h"
+#include <random>
+
+namespace {
+
+    // SHA-256 round constants
+    const uint32_t kRoundConstants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    // Block size of SHA-256, which is also the HMAC key block size
+    const size_t kBlockSize = 64;
+
+    inline uint32_t RotateRight(uint32_t value, int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+}
+
+// Returns the SHA-256 digest of the data
+std::string Hmac::Sha256(const std::string& data) {
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    // Full blocks straight from the input
+    size_t offset = 0;
+    for (; offset + kBlockSize <= data.size(); offset += kBlockSize) {
+        Transform(state, reinterpret_cast<const unsigned char*>(data.data() + offset));
+    }
+
+    // Padding: 0x80, zeros, then the bit length big-endian in the last 8 bytes
+    unsigned char tail[2 * kBlockSize] = { 0 };
+    size_t rest = data.size() % kBlockSize;
+    for (size_t i = 0; i < rest; ++i) {
+        tail[i] = static_cast<unsigned char>(data[offset + i]);
+    }
+    tail[rest] = 0x80;
+
+    size_t tailSize = rest + 9 <= kBlockSize ? kBlockSize : 2 * kBlockSize;
+    uint64_t bitLength = static_cast<uint64_t>(data.size()) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tailSize - 1 - i] = static_cast<unsigned char>(bitLength >> (8 * i));
+    }
+
+    for (size_t block = 0; block < tailSize; block += kBlockSize) {
+        Transform(state, tail + block);
+    }
+
+    std::string digest(kDigestSize, '\0');
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<char>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<char>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<char>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<char>(state[i]);
+    }
+    return digest;
+}
+
+// Returns the HMAC-SHA256 of a message
+std::string Hmac::Sign(const std::string& key, const std::string& message) {
+    // Keys longer than a block are hashed first
+    std::string blockKey = key.size() > kBlockSize ? Sha256(key) : key;
+    blockKey.resize(kBlockSize, '\0');
+
+    std::string inner(kBlockSize, '\0');
+    std::string outer(kBlockSize, '\0');
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        inner[i] = static_cast<char>(blockKey[i] ^ 0x36);
+        outer[i] = static_cast<char>(blockKey[i] ^ 0x5c);
+    }
+
+    return Sha256(outer + Sha256(inner + message));
+}
+
+// Compares two MACs in constant time
+bool Hmac::Equal(const std::string& mac, const std::string& expected) {
+    if (mac.size() != expected.size()) {
+        return false;
+    }
+
+    unsigned char difference = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        difference |= static_cast<unsigned char>(expected[i] ^ mac[i]);
+    }
+    return difference == 0;
+}
+
+// Returns a random nonce
+std::string Hmac::MakeNonce() {
+    // random_device reads the OS generator (rand_s on Windows, /dev/urandom or RDRAND elsewhere)
+    std::random_device source;
+    std::string nonce(kDigestSize, '\0');
+    for (size_t i = 0; i < nonce.size(); i += 4) {
+        uint32_t value = source();
+        for (size_t b = 0; b < 4 && i + b < nonce.size(); ++b) {
+            nonce[i + b] = static_cast<char>(value >> (8 * b));
+        }
+    }
+    return nonce;
+}
+
+// Processes one 64-byte block
+void Hmac::Transform(uint32_t state[8], const unsigned char block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<uint32_t>(block[4 * i]) << 24) | (static_cast<uint32_t>(block[4 * i + 1]) << 16) |
+            (static_cast<uint32_t>(block[4 * i + 2]) << 8) | static_cast<uint32_t>(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; ++i) {
+        uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+        uint32_t choose = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + choose + kRoundConstants[i] + w[i];
+        uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
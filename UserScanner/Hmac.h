@@ -0,0 +1,52 @@
+#ifndef HMAC_H
+#define HMAC_H
+
+#include <string>
+#include <cstdint>
+
+/**
+ * @class Hmac
+ * @brief HMAC-SHA256 (RFC 2104, FIPS 180-4) for the coordinator/worker handshake and frame MACs
+ *
+ * Self-contained so the distributed mode needs no crypto library. Keys,
+ * messages and digests are byte strings.
+ */
+class Hmac {
+public:
+    /**
+     * @brief Size of a digest and of a nonce in bytes
+     */
+    static const size_t kDigestSize = 32;
+
+    /**
+     * @brief Returns the SHA-256 digest of the data
+     */
+    static std::string Sha256(const std::string& data);
+
+    /**
+     * @brief Returns the HMAC-SHA256 of a message
+     * @param key Shared secret
+     * @param message Message to authenticate
+     * @return 32-byte MAC
+     */
+    static std::string Sign(const std::string& key, const std::string& message);
+
+    /**
+     * @brief Compares two MACs in constant time
+     * @return True if both are equal
+     */
+    static bool Equal(const std::string& mac, const std::string& expected);
+
+    /**
+     * @brief Returns a random nonce of kDigestSize bytes from the system random source
+     */
+    static std::string MakeNonce();
+
+private:
+    /**
+     * @brief Processes one 64-byte block
+     */
+    static void Transform(uint32_t state[8], const unsigned char block[64]);
+};
+
+#endif // HMAC_H
@@ -0,0 +1,222 @@
+#include "HostCache.h"
+#include "Platform.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <cwctype>
+#include <stdexcept>
+#include <algorithm>
+
+namespace {
+
+    // File format: a header line, then per host one H record followed by its
+    // K (subkey) and U (user) records; fields are tab-separated UTF-8
+    const char* const kHeader = "# UserScanner host cache v1";
+
+    std::vector<std::wstring> SplitTabs(const std::wstring& line) {
+        std::vector<std::wstring> fields;
+        size_t start = 0;
+        for (;;) {
+            size_t pos = line.find(L'\t', start);
+            fields.push_back(line.substr(start, pos == std::wstring::npos ? std::wstring::npos : pos - start));
+            if (pos == std::wstring::npos) {
+                break;
+            }
+            start = pos + 1;
+        }
+        return fields;
+    }
+}
+
+// Constructor
+HostCache::HostCache(const std::wstring& path)
+    : m_path(path)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+// Loads the cache file
+void HostCache::Load() {
+    std::ifstream input(ToNativePath(m_path));
+    if (!input.is_open()) {
+        std::wcout << L"[INFO] Host cache not found, starting empty: " << m_path << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+
+    std::string rawLine;
+    HostCacheEntry* current = nullptr;
+    size_t lineNumber = 0;
+
+    while (std::getline(input, rawLine)) {
+        lineNumber++;
+        if (!rawLine.empty() && rawLine.back() == '\r') {
+            rawLine.pop_back();
+        }
+        if (rawLine.empty() || rawLine[0] == '#') {
+            continue;
+        }
+
+        auto fields = SplitTabs(UTF8ToWide(rawLine));
+
+        try {
+            if (fields[0] == L"H" && fields.size() == 4) {
+                HostCacheEntry& entry = m_entries[MakeKey(fields[1])];
+                entry = HostCacheEntry();
+                entry.lastWriteTime = std::stoull(fields[2]);
+                entry.subKeyCount = static_cast<uint32_t>(std::stoul(fields[3]));
+                current = &entry;
+            }
+            else if (fields[0] == L"K" && fields.size() == 2 && current) {
+                current->subKeys.push_back(fields[1]);
+            }
+            else if (fields[0] == L"U" && fields.size() == 4 && current) {
+                current->users.emplace_back(fields[1], fields[3], fields[2]);
+            }
+            else {
+                throw std::invalid_argument("record");
+            }
+        }
+        catch (...) {
+            std::wcerr << L"[WARNING] Invalid host cache record at line " << lineNumber
+                << L", starting empty: " << m_path << std::endl;
+            m_entries.clear();
+            return;
+        }
+    }
+
+    std::wcout << L"[INFO] Host cache loaded: " << m_entries.size() << L" hosts" << std::endl;
+}
+
+// Writes all entries to the cache file
+bool HostCache::Save() {
+    std::wstring tempPath = m_path + L".tmp";
+    std::ofstream output(ToNativePath(tempPath), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!output.is_open()) {
+        std::wcerr << L"[ERROR] Could not write host cache: " << tempPath << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    output << kHeader << "\n";
+    for (const auto& item : m_entries) {
+        const HostCacheEntry& entry = item.second;
+
+        output << "H\t" << WideToUTF8(item.first) << "\t" << entry.lastWriteTime
+            << "\t" << entry.subKeyCount << "\n";
+        for (const auto& subKey : entry.subKeys) {
+            output << "K\t" << WideToUTF8(subKey) << "\n";
+        }
+        for (const auto& user : entry.users) {
+            output << "U\t" << WideToUTF8(user.sid) << "\t" << WideToUTF8(user.domainName)
+                << "\t" << WideToUTF8(user.userName) << "\n";
+        }
+    }
+
+    output.close();
+    if (!output) {
+        std::wcerr << L"[ERROR] Could not write host cache: " << tempPath << std::endl;
+        RemoveFile(tempPath);
+        return false;
+    }
+
+    // Only a complete file replaces the previous cache
+    if (!ReplaceWithFile(tempPath, m_path)) {
+        std::wcerr << L"[ERROR] Could not replace host cache: " << m_path << std::endl;
+        RemoveFile(tempPath);
+        return false;
+    }
+
+    return true;
+}
+
+// Returns the cached users if the host is unchanged
+bool HostCache::Lookup(const std::wstring& hostname, uint64_t lastWriteTime, uint32_t subKeyCount,
+    std::vector<UserInfo>& users) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(MakeKey(hostname));
+        if (it != m_entries.end() &&
+            it->second.lastWriteTime == lastWriteTime &&
+            it->second.subKeyCount == subKeyCount) {
+            users = it->second.users;
+            m_hits++;
+            return true;
+        }
+    }
+
+    m_misses++;
+    return false;
+}
+
+// Stores the observed state of a host
+void HostCache::Store(const std::wstring& hostname, HostCacheEntry entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[MakeKey(hostname)] = std::move(entry);
+}
+
+// Returns the hosts on which any of the subkeys was last seen
+std::vector<std::wstring> HostCache::FindHostsWithSubKey(const std::vector<std::wstring>& subKeys) {
+    std::vector<std::wstring> wanted;
+    for (const auto& subKey : subKeys) {
+        wanted.push_back(MakeKey(subKey));
+    }
+
+    std::vector<std::wstring> hosts;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& item : m_entries) {
+        for (const auto& subKey : item.second.subKeys) {
+            if (std::find(wanted.begin(), wanted.end(), MakeKey(subKey)) != wanted.end()) {
+                hosts.push_back(item.first);
+                break;
+            }
+        }
+    }
+
+    return hosts;
+}
+
+// Checks whether the host is in the cache
+bool HostCache::Contains(const std::wstring& hostname) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.find(MakeKey(hostname)) != m_entries.end();
+}
+
+// Drops the entries of hosts missing from the enumeration
+size_t HostCache::Prune(const std::vector<ComputerInfo>& computers) {
+    std::unordered_set<std::wstring> current;
+    current.reserve(computers.size());
+    for (const auto& computer : computers) {
+        current.insert(MakeKey(computer.hostname));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t dropped = 0;
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (current.count(it->first)) {
+            ++it;
+        }
+        else {
+            it = m_entries.erase(it);
+            dropped++;
+        }
+    }
+
+    return dropped;
+}
+
+// Normalizes a host name or SID for comparison
+std::wstring HostCache::MakeKey(const std::wstring& hostname) {
+    std::wstring key = hostname;
+    for (auto& ch : key) {
+        ch = static_cast<wchar_t>(std::towlower(ch));
+    }
+    return key;
+}
@@ -0,0 +1,116 @@
+#ifndef HOSTCACHE_H
+#define HOSTCACHE_H
+
+#include "ADHelper.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct HostCacheEntry
+ * @brief Last observed HKEY_USERS state of one host
+ */
+struct HostCacheEntry {
+    uint64_t lastWriteTime = 0;             // HKEY_USERS last-write time (FILETIME)
+    uint32_t subKeyCount = 0;               // Number of HKEY_USERS subkeys
+    std::vector<std::wstring> subKeys;      // Subkey names
+    std::vector<UserInfo> users;            // Resolved users
+};
+
+/**
+ * @class HostCache
+ * @brief Per-host cache of logged-on users, persisted between scans
+ *
+ * A host whose HKEY_USERS last-write time and subkey count are unchanged
+ * since the previous scan has the same loaded profiles, so its cached users
+ * can be reused without enumerating subkeys or looking up any SID.
+ */
+class HostCache {
+public:
+    /**
+     * @brief Constructs the cache
+     * @param path Cache file path
+     */
+    explicit HostCache(const std::wstring& path);
+
+    /**
+     * @brief Loads the cache file
+     *
+     * A missing or unreadable file is an empty cache: the scan then probes
+     * every host in full and the next Save() rewrites the file.
+     */
+    void Load();
+
+    /**
+     * @brief Writes all entries to the cache file
+     *
+     * The entries go to "<path>.tmp", which then replaces the file, so an
+     * interrupted write leaves the previous cache intact.
+     *
+     * @return True if successful
+     */
+    bool Save();
+
+    /**
+     * @brief Returns the cached users if the host's HKEY_USERS key is unchanged (thread-safe)
+     * @param hostname Host name
+     * @param lastWriteTime Current last-write time of HKEY_USERS
+     * @param subKeyCount Current number of subkeys
+     * @param users Receives the cached users on a hit
+     * @return True on a cache hit
+     */
+    bool Lookup(const std::wstring& hostname, uint64_t lastWriteTime, uint32_t subKeyCount,
+        std::vector<UserInfo>& users);
+
+    /**
+     * @brief Stores the observed state of a host (thread-safe)
+     */
+    void Store(const std::wstring& hostname, HostCacheEntry entry);
+
+    /**
+     * @brief Returns the hosts whose last observed subkeys include any of the given names
+     * @param subKeys Subkey names (SIDs) to look for, compared case-insensitively
+     * @return Host names (lower case)
+     */
+    std::vector<std::wstring> FindHostsWithSubKey(const std::vector<std::wstring>& subKeys);
+
+    /**
+     * @brief Returns true if the host answered in a previous scan
+     */
+    bool Contains(const std::wstring& hostname);
+
+    /**
+     * @brief Normalizes a host name or SID for case-insensitive comparison
+     */
+    static std::wstring MakeKey(const std::wstring& hostname);
+
+    /**
+     * @brief Drops the entries of hosts that are not in the given enumeration
+     *
+     * Call only with a full directory enumeration; decommissioned and renamed
+     * hosts then stop taking space in the cache.
+     *
+     * @param computers Computers of the current enumeration
+     * @return Number of entries dropped
+     */
+    size_t Prune(const std::vector<ComputerInfo>& computers);
+
+    /**
+     * @brief Returns statistics
+     */
+    uint64_t GetHits() const { return m_hits; }
+    uint64_t GetMisses() const { return m_misses; }
+
+private:
+    std::wstring m_path;                                        // Cache file path
+    std::mutex m_mutex;                                         // Protects m_entries
+    std::unordered_map<std::wstring, HostCacheEntry> m_entries; // Entries by lower-case host name
+    std::atomic<uint64_t> m_hits;                               // Lookups answered from the cache
+    std::atomic<uint64_t> m_misses;                             // Lookups that required a full probe
+};
+
+#endif // HOSTCACHE_H
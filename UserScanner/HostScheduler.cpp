@@ -0,0 +1,159 @@
+#include "HostScheduler.h"
+#include <unordered_map>
+#include <algorithm>
+
+// Constructor
+HostScheduler::HostScheduler(const std::vector<ComputerInfo>& computers, const SchedulerOptions& options)
+    : m_options(options)
+    , m_cursor(0)
+    , m_remaining(computers.size())
+{
+    std::unordered_map<std::wstring, size_t> groupIndex;
+    Clock::time_point now = Clock::now();
+
+    // A full bucket lets each segment start with one second worth of connections
+    double burst = std::max(1.0, m_options.connectRate);
+
+    m_hostGroup.resize(computers.size());
+    for (size_t i = 0; i < computers.size(); ++i) {
+        std::wstring key = GetGroupKey(computers[i]);
+
+        auto it = groupIndex.find(key);
+        if (it == groupIndex.end()) {
+            it = groupIndex.emplace(key, m_groups.size()).first;
+            Group group;
+            group.tokens = burst;
+            group.lastRefill = now;
+            group.limited = !key.empty();
+            m_groups.push_back(group);
+        }
+
+        m_groups[it->second].hosts.push_back(i);
+        m_hostGroup[i] = it->second;
+    }
+}
+
+// Takes the next host that may be probed
+bool HostScheduler::Next(size_t& index) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;) {
+        if (m_remaining == 0) {
+            return false;
+        }
+
+        Clock::time_point now = Clock::now();
+        Clock::time_point wakeUp = Clock::time_point::max();
+
+        // One pass over the segments, starting after the last one served
+        for (size_t step = 0; step < m_groups.size(); ++step) {
+            size_t g = (m_cursor + step) % m_groups.size();
+            Group& group = m_groups[g];
+
+            if (group.next >= group.hosts.size() || !TryTake(group, now, wakeUp)) {
+                continue;
+            }
+
+            index = group.hosts[group.next++];
+            m_cursor = g + 1;
+
+            // Threads still waiting have nothing left to take
+            if (--m_remaining == 0) {
+                m_cv.notify_all();
+            }
+            return true;
+        }
+
+        // Every segment with hosts left is at its limit: wait for a slot or a token
+        if (wakeUp == Clock::time_point::max()) {
+            m_cv.wait(lock);
+        }
+        else {
+            m_cv.wait_until(lock, wakeUp);
+        }
+    }
+}
+
+// Takes a segment slot for a host handed out before
+void HostScheduler::Acquire(size_t index) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Group& group = m_groups[m_hostGroup[index]];
+
+    for (;;) {
+        Clock::time_point wakeUp = Clock::time_point::max();
+        if (TryTake(group, Clock::now(), wakeUp)) {
+            return;
+        }
+
+        if (wakeUp == Clock::time_point::max()) {
+            m_cv.wait(lock);
+        }
+        else {
+            m_cv.wait_until(lock, wakeUp);
+        }
+    }
+}
+
+// Releases the segment slot of a finished host
+void HostScheduler::Finished(size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_groups[m_hostGroup[index]].inFlight--;
+    }
+
+    // Threads in Acquire() wait for one particular segment, so all waiters must see the slot
+    m_cv.notify_all();
+}
+
+// Takes a slot and a token of the segment if its limits allow
+bool HostScheduler::TryTake(Group& group, Clock::time_point now, Clock::time_point& wakeUp) {
+    if (group.limited) {
+        if (m_options.maxInFlight > 0 && group.inFlight >= m_options.maxInFlight) {
+            return false;
+        }
+
+        if (m_options.connectRate > 0) {
+            Refill(group, now);
+            if (group.tokens < 1.0) {
+                // Time until this segment earns its next token
+                auto wait = std::chrono::duration<double>((1.0 - group.tokens) / m_options.connectRate);
+                wakeUp = std::min(wakeUp, now + std::chrono::duration_cast<Clock::duration>(wait));
+                return false;
+            }
+            group.tokens -= 1.0;
+        }
+    }
+
+    group.inFlight++;
+    return true;
+}
+
+// Returns the segment key of a host
+std::wstring HostScheduler::GetGroupKey(const ComputerInfo& computer) {
+    const std::wstring& address = computer.address;
+    if (address.empty()) {
+        return L"";
+    }
+
+    // IPv4: the /24 network
+    if (address.find(L':') == std::wstring::npos) {
+        size_t lastDot = address.rfind(L'.');
+        return lastDot == std::wstring::npos ? address : address.substr(0, lastDot);
+    }
+
+    // IPv6: the first four groups (/64); "::" compression shortens the prefix, which is fine for grouping
+    int colons = 0;
+    for (size_t i = 0; i < address.size(); ++i) {
+        if (address[i] == L':' && ++colons == 4) {
+            return address.substr(0, i);
+        }
+    }
+    return address;
+}
+
+// Adds the tokens earned since the last refill
+void HostScheduler::Refill(Group& group, Clock::time_point now) const {
+    double elapsed = std::chrono::duration<double>(now - group.lastRefill).count();
+    group.tokens = std::min(std::max(1.0, m_options.connectRate), group.tokens + elapsed * m_options.connectRate);
+    group.lastRefill = now;
+}
@@ -0,0 +1,109 @@
+#ifndef HOSTSCHEDULER_H
+#define HOSTSCHEDULER_H
+
+#include "ADHelper.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * @struct SchedulerOptions
+ * @brief Per-segment connection limits
+ */
+struct SchedulerOptions {
+    int maxInFlight = 0;            // Concurrent probes per subnet (0 = unlimited)
+    double connectRate = 0;         // New connections per second per subnet (0 = unlimited)
+};
+
+/**
+ * @class HostScheduler
+ * @brief Hands hosts to scan threads, interleaved across network segments
+ *
+ * Hosts are grouped by subnet (/24 for IPv4, /64 for IPv6) of their
+ * pre-resolved address. Threads take hosts round-robin across groups, and
+ * each group can have a cap on probes in flight and a token bucket on new
+ * connections (both off by default), so a branch office behind a thin link is never hit by the
+ * whole thread pool at once while other segments sit idle. Hosts without
+ * an address form one group without limits. Retries of hosts already
+ * handed out take their segment slot with Acquire(), under the same limits.
+ */
+class HostScheduler {
+public:
+    /**
+     * @brief Constructs the scheduler
+     * @param computers Hosts to schedule (must outlive the scheduler)
+     * @param options Per-segment limits
+     */
+    HostScheduler(const std::vector<ComputerInfo>& computers, const SchedulerOptions& options);
+
+    /**
+     * @brief Waits until a host may be probed and takes it (thread-safe)
+     * @param index Receives the index of the host
+     * @return False when every host has been handed out
+     */
+    bool Next(size_t& index);
+
+    /**
+     * @brief Waits until the segment of a host has a free slot and a token, and takes them (thread-safe)
+     *
+     * For probing a host again after Next() handed it out, e.g. a retry.
+     *
+     * @param index Index of the host
+     */
+    void Acquire(size_t index);
+
+    /**
+     * @brief Releases the segment slot of a finished host (thread-safe)
+     * @param index Index returned by Next() or passed to Acquire()
+     */
+    void Finished(size_t index);
+
+    /**
+     * @brief Returns the number of segments
+     */
+    size_t GetGroupCount() const { return m_groups.size(); }
+
+    /**
+     * @brief Returns the segment key of a host ("" if it has no address)
+     */
+    static std::wstring GetGroupKey(const ComputerInfo& computer);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Hosts of one segment and its limits
+     */
+    struct Group {
+        std::vector<size_t> hosts;      // Host indexes in enumeration order
+        size_t next = 0;                // Next host to hand out
+        int inFlight = 0;               // Probes running
+        double tokens = 0;              // Connection tokens available
+        Clock::time_point lastRefill;   // Last token refill
+        bool limited = true;            // Limits apply (false for hosts without an address)
+    };
+
+    SchedulerOptions m_options;         // Per-segment limits
+    std::vector<Group> m_groups;        // Segments
+    std::vector<size_t> m_hostGroup;    // Segment of each host
+    std::mutex m_mutex;                 // Protects all state
+    std::condition_variable m_cv;       // Signals released slots
+    size_t m_cursor;                    // Round-robin position
+    size_t m_remaining;                 // Hosts not handed out yet
+
+    /**
+     * @brief Takes a slot and a token of the segment if its limits allow
+     * @param wakeUp Lowered to the time the next token is earned when the bucket is empty
+     * @return True if the slot was taken
+     */
+    bool TryTake(Group& group, Clock::time_point now, Clock::time_point& wakeUp);
+
+    /**
+     * @brief Adds the tokens earned since the last refill
+     */
+    void Refill(Group& group, Clock::time_point now) const;
+};
+
+#endif // HOSTSCHEDULER_H
@@ -1,4 +1,9 @@
 #include "LDAPQuery.h"
+#include "Tracer.h"
+
+// Windows LDAP backend (wldap32); see LDAPQueryOpenLDAP.cpp for other platforms
+#ifdef _WIN32
+
 #include <iostream>
 #include <sstream>
 
@@ -55,6 +60,8 @@ bool LDAPQuery::Initialize() {
 }
 
 bool LDAPQuery::Bind() {
+    TraceSpan span("ldap_bind", "ldap", m_domainController);
+
     if (!m_ldap) {
         std::wcerr << L"[ERROR] LDAP not initialized." << std::endl;
         return false;
@@ -75,6 +82,8 @@ bool LDAPQuery::Bind() {
 bool LDAPQuery::Search(const std::wstring& baseDN,
     const std::wstring& filter,
     const std::vector<std::wstring>& attributes) {
+    TraceSpan span("ldap_search", "ldap", filter);
+
     if (!m_ldap) {
         std::wcerr << L"[ERROR] LDAP connection not available." << std::endl;
         return false;
@@ -165,6 +174,48 @@ std::vector<std::wstring> LDAPQuery::GetAttributeValues(const std::wstring& attr
     return results;
 }
 
+// One row per entry with the first value of each attribute ("" if absent),
+// so attributes missing on some entries cannot shift the columns
+std::vector<std::vector<std::wstring>> LDAPQuery::GetEntries(const std::vector<std::wstring>& attributes) {
+    std::vector<std::vector<std::wstring>> rows;
+
+    if (!m_ldap || !m_searchResult) {
+        std::wcerr << L"[WARNING] No search results available." << std::endl;
+        return rows;
+    }
+
+    std::vector<PWSTR> attrNames;
+    for (const auto& attribute : attributes) {
+        attrNames.push_back(AllocateWideString(attribute));
+    }
+
+    for (LDAPMessage* entry = ldap_first_entry(m_ldap, m_searchResult);
+        entry != nullptr;
+        entry = ldap_next_entry(m_ldap, entry)) {
+
+        std::vector<std::wstring> row(attributes.size());
+        for (size_t i = 0; i < attrNames.size(); ++i) {
+            if (!attrNames[i]) {
+                continue;
+            }
+
+            PWSTR* values = ldap_get_valuesW(m_ldap, entry, attrNames[i]);
+            if (values) {
+                if (values[0] != nullptr) {
+                    row[i] = values[0];
+                }
+                ldap_value_freeW(values);
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+
+    for (PWSTR attrName : attrNames) {
+        delete[] attrName;
+    }
+    return rows;
+}
+
 std::wstring LDAPQuery::GetLastError() const {
     if (m_lastErrorCode == LDAP_SUCCESS) {
         return L"No error";
@@ -201,3 +252,5 @@ PWSTR LDAPQuery::AllocateWideString(const std::wstring& str) {
 
     return buffer;
 }
+
+#endif // _WIN32
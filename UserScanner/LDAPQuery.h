@@ -1,39 +1,51 @@
 #ifndef LDAPQUERY_H
 #define LDAPQUERY_H
 
+#ifdef _WIN32
 #include <windows.h>
 #include <winldap.h>
+#else
+#include <ldap.h>
+#endif
 #include <string>
 #include <vector>
 #include <memory>
 
+// Methods are virtual so benchmark mode can substitute an in-process directory
 class LDAPQuery {
 public:
     explicit LDAPQuery(const std::wstring& domainController);
-    ~LDAPQuery();
+    virtual ~LDAPQuery();
 
     LDAPQuery(const LDAPQuery&) = delete;
     LDAPQuery& operator=(const LDAPQuery&) = delete;
     LDAPQuery(LDAPQuery&&) = delete;
     LDAPQuery& operator=(LDAPQuery&&) = delete;
 
-    bool Initialize();
-    bool Bind();
-    bool Search(const std::wstring& baseDN,
+    virtual bool Initialize();
+    virtual bool Bind();
+    virtual bool Search(const std::wstring& baseDN,
         const std::wstring& filter,
         const std::vector<std::wstring>& attributes);
 
-    std::vector<std::wstring> GetAttributeValues(const std::wstring& attributeName);
-    std::wstring GetLastError() const;
+    virtual std::vector<std::wstring> GetAttributeValues(const std::wstring& attributeName);
+    virtual std::vector<std::vector<std::wstring>> GetEntries(const std::vector<std::wstring>& attributes);
+    virtual std::wstring GetLastError() const;
 
 private:
     LDAP* m_ldap;
     LDAPMessage* m_searchResult;
     std::wstring m_domainController;
+#ifdef _WIN32
     ULONG m_lastErrorCode;
+#else
+    int m_lastErrorCode;
+#endif
 
     void ClearSearchResults();
+#ifdef _WIN32
     PWSTR AllocateWideString(const std::wstring& str);
+#endif
 
     static int GetLDAPVersion() { return LDAP_VERSION3; }
     static int GetLDAPPort() { return LDAP_PORT; }
@@ -0,0 +1,239 @@
+#include "LDAPQuery.h"
+#include "Tracer.h"
+
+// OpenLDAP backend (libldap + Cyrus SASL) for non-Windows builds
+#ifndef _WIN32
+
+#include "Platform.h"
+#include <sasl/sasl.h>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+    // SASL interaction callback: GSSAPI takes its identity from the Kerberos
+    // credential cache, so every prompt is answered with the library default
+    int SaslInteract(LDAP* /*ld*/, unsigned /*flags*/, void* /*defaults*/, void* in) {
+        for (sasl_interact_t* interact = static_cast<sasl_interact_t*>(in);
+            interact->id != SASL_CB_LIST_END;
+            ++interact) {
+            const char* value = static_cast<const char*>(interact->defresult);
+            interact->result = value ? value : "";
+            interact->len = value ? static_cast<unsigned>(strlen(value)) : 0;
+        }
+        return LDAP_SUCCESS;
+    }
+}
+
+LDAPQuery::LDAPQuery(const std::wstring& domainController)
+    : m_ldap(nullptr)
+    , m_searchResult(nullptr)
+    , m_domainController(domainController)
+    , m_lastErrorCode(0)
+{
+}
+
+LDAPQuery::~LDAPQuery() {
+    ClearSearchResults();
+    if (m_ldap) {
+        ldap_unbind_ext_s(m_ldap, nullptr, nullptr);
+        m_ldap = nullptr;
+    }
+}
+
+bool LDAPQuery::Initialize() {
+    if (m_ldap) {
+        ldap_unbind_ext_s(m_ldap, nullptr, nullptr);
+        m_ldap = nullptr;
+    }
+
+    std::ostringstream uri;
+    uri << "ldap://" << WideToUTF8(m_domainController) << ":" << GetLDAPPort();
+
+    m_lastErrorCode = ldap_initialize(&m_ldap, uri.str().c_str());
+
+    if (m_lastErrorCode != LDAP_SUCCESS || !m_ldap) {
+        std::wcerr << L"[ERROR] LDAP initialization failed: " << m_domainController << std::endl;
+        m_ldap = nullptr;
+        return false;
+    }
+
+    int version = GetLDAPVersion();
+    m_lastErrorCode = ldap_set_option(m_ldap, LDAP_OPT_PROTOCOL_VERSION, &version);
+
+    if (m_lastErrorCode != LDAP_SUCCESS) {
+        std::wcerr << L"[ERROR] Could not set LDAP options. Error code: "
+            << m_lastErrorCode << std::endl;
+        ldap_unbind_ext_s(m_ldap, nullptr, nullptr);
+        m_ldap = nullptr;
+        return false;
+    }
+
+    // AD returns referrals to other naming contexts for domain-root searches;
+    // chasing them would need a separate authenticated bind per referral
+    ldap_set_option(m_ldap, LDAP_OPT_REFERRALS, LDAP_OPT_OFF);
+
+    return true;
+}
+
+bool LDAPQuery::Bind() {
+    TraceSpan span("ldap_bind", "ldap", m_domainController);
+
+    if (!m_ldap) {
+        std::wcerr << L"[ERROR] LDAP not initialized." << std::endl;
+        return false;
+    }
+
+    // Kerberos bind with the caller's ticket (kinit or a keytab)
+    m_lastErrorCode = ldap_sasl_interactive_bind_s(m_ldap, nullptr, "GSSAPI",
+        nullptr, nullptr, LDAP_SASL_QUIET, SaslInteract, nullptr);
+
+    if (m_lastErrorCode != LDAP_SUCCESS) {
+        std::wcerr << L"[ERROR] LDAP bind failed. Error code: "
+            << m_lastErrorCode << std::endl;
+        return false;
+    }
+
+    std::wcout << L"[INFO] LDAP bind successful: " << m_domainController << std::endl;
+    return true;
+}
+
+bool LDAPQuery::Search(const std::wstring& baseDN,
+    const std::wstring& filter,
+    const std::vector<std::wstring>& attributes) {
+    TraceSpan span("ldap_search", "ldap", filter);
+
+    if (!m_ldap) {
+        std::wcerr << L"[ERROR] LDAP connection not available." << std::endl;
+        return false;
+    }
+
+    ClearSearchResults();
+
+    std::string baseDNStr = WideToUTF8(baseDN);
+    std::string filterStr = WideToUTF8(filter);
+
+    std::vector<std::string> attrStrings;
+    for (const auto& attr : attributes) {
+        attrStrings.push_back(WideToUTF8(attr));
+    }
+
+    std::vector<char*> attrArray;
+    for (auto& attr : attrStrings) {
+        attrArray.push_back(&attr[0]);
+    }
+    attrArray.push_back(nullptr);
+
+    m_lastErrorCode = ldap_search_ext_s(
+        m_ldap,
+        baseDNStr.c_str(),
+        LDAP_SCOPE_SUBTREE,
+        filterStr.c_str(),
+        attrArray.data(),
+        0,
+        nullptr,
+        nullptr,
+        nullptr,
+        0,
+        &m_searchResult
+    );
+
+    if (m_lastErrorCode != LDAP_SUCCESS) {
+        std::wcerr << L"[ERROR] LDAP search failed. Error code: "
+            << m_lastErrorCode << std::endl;
+        std::wcerr << L"  BaseDN: " << baseDN << std::endl;
+        std::wcerr << L"  Filter: " << filter << std::endl;
+        return false;
+    }
+
+    int count = ldap_count_entries(m_ldap, m_searchResult);
+    std::wcout << L"[INFO] " << count << L" results found." << std::endl;
+
+    return true;
+}
+
+std::vector<std::wstring> LDAPQuery::GetAttributeValues(const std::wstring& attributeName) {
+    std::vector<std::wstring> results;
+
+    if (!m_ldap || !m_searchResult) {
+        std::wcerr << L"[WARNING] No search results available." << std::endl;
+        return results;
+    }
+
+    std::string attrName = WideToUTF8(attributeName);
+
+    for (LDAPMessage* entry = ldap_first_entry(m_ldap, m_searchResult);
+        entry != nullptr;
+        entry = ldap_next_entry(m_ldap, entry)) {
+
+        struct berval** values = ldap_get_values_len(m_ldap, entry, attrName.c_str());
+
+        if (values) {
+            for (int i = 0; values[i] != nullptr; ++i) {
+                results.push_back(UTF8ToWide(std::string(values[i]->bv_val, values[i]->bv_len)));
+            }
+            ldap_value_free_len(values);
+        }
+    }
+
+    return results;
+}
+
+// One row per entry with the first value of each attribute ("" if absent)
+std::vector<std::vector<std::wstring>> LDAPQuery::GetEntries(const std::vector<std::wstring>& attributes) {
+    std::vector<std::vector<std::wstring>> rows;
+
+    if (!m_ldap || !m_searchResult) {
+        std::wcerr << L"[WARNING] No search results available." << std::endl;
+        return rows;
+    }
+
+    std::vector<std::string> attrNames;
+    for (const auto& attribute : attributes) {
+        attrNames.push_back(WideToUTF8(attribute));
+    }
+
+    for (LDAPMessage* entry = ldap_first_entry(m_ldap, m_searchResult);
+        entry != nullptr;
+        entry = ldap_next_entry(m_ldap, entry)) {
+
+        std::vector<std::wstring> row(attributes.size());
+        for (size_t i = 0; i < attrNames.size(); ++i) {
+            struct berval** values = ldap_get_values_len(m_ldap, entry, attrNames[i].c_str());
+            if (values) {
+                if (values[0] != nullptr) {
+                    row[i] = UTF8ToWide(std::string(values[0]->bv_val, values[0]->bv_len));
+                }
+                ldap_value_free_len(values);
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+
+    return rows;
+}
+
+std::wstring LDAPQuery::GetLastError() const {
+    if (m_lastErrorCode == LDAP_SUCCESS) {
+        return L"No error";
+    }
+
+    const char* errorMsg = ldap_err2string(m_lastErrorCode);
+    if (errorMsg) {
+        return UTF8ToWide(errorMsg);
+    }
+
+    std::wstringstream ss;
+    ss << L"Unknown error (code: " << m_lastErrorCode << L")";
+    return ss.str();
+}
+
+void LDAPQuery::ClearSearchResults() {
+    if (m_searchResult) {
+        ldap_msgfree(m_searchResult);
+        m_searchResult = nullptr;
+    }
+}
+
+#endif // !_WIN32
@@ -0,0 +1,366 @@
+#include "NetChannel.h"
+#include "Platform.h"
+#include "Hmac.h"
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+#ifdef _WIN32
+    const SocketHandle kInvalidSocket = INVALID_SOCKET;
+
+    void CloseSocket(SocketHandle socket) {
+        closesocket(socket);
+    }
+
+    void SetSocketTimeout(SocketHandle socket, int option, int seconds) {
+        DWORD milliseconds = static_cast<DWORD>(seconds) * 1000;
+        setsockopt(socket, SOL_SOCKET, option, reinterpret_cast<const char*>(&milliseconds), sizeof(milliseconds));
+    }
+
+    // Winsock stays initialized for the life of the process
+    bool InitializeSockets() {
+        static bool initialized = [] {
+            WSADATA wsaData;
+            return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+        }();
+        return initialized;
+    }
+#else
+    const SocketHandle kInvalidSocket = -1;
+
+    void CloseSocket(SocketHandle socket) {
+        close(socket);
+    }
+
+    void SetSocketTimeout(SocketHandle socket, int option, int seconds) {
+        timeval timeout = {};
+        timeout.tv_sec = seconds;
+        setsockopt(socket, SOL_SOCKET, option, &timeout, sizeof(timeout));
+    }
+
+    bool InitializeSockets() {
+        return true;
+    }
+#endif
+
+    // Largest frame accepted from a peer
+    const uint32_t kMaxFrameSize = 256u * 1024 * 1024;
+
+    // Largest frame accepted before the session keys are set; handshake frames are under 1 KB
+    const uint32_t kMaxHandshakeFrameSize = 4 * 1024;
+
+    // MAC input of a frame: sequence number (8 bytes little-endian), type, payload
+    std::string MakeMacInput(uint64_t sequence, uint8_t type, const std::string& payload) {
+        std::string input;
+        input.reserve(9 + payload.size());
+        for (int i = 0; i < 8; ++i) {
+            input += static_cast<char>((sequence >> (8 * i)) & 0xFF);
+        }
+        input += static_cast<char>(type);
+        input += payload;
+        return input;
+    }
+
+    // Listen address when the endpoint is only a port; other machines need an explicit address
+    const char* const kDefaultListenAddress = "127.0.0.1";
+}
+
+// Constructor
+NetChannel::NetChannel()
+    : m_socket(kInvalidSocket)
+    , m_sendSequence(0)
+    , m_receiveSequence(0)
+{
+}
+
+// Destructor
+NetChannel::~NetChannel() {
+    Close();
+}
+
+// Starts listening
+bool NetChannel::Listen(const std::wstring& endpoint) {
+    std::string address;
+    std::string port;
+    if (!InitializeSockets() || !ParseEndpoint(endpoint, address, port)) {
+        std::wcerr << L"[ERROR] Invalid listen endpoint: " << endpoint << std::endl;
+        return false;
+    }
+
+    if (address.empty()) {
+        address = kDefaultListenAddress;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(address.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        std::wcerr << L"[ERROR] Could not resolve listen endpoint: " << endpoint << std::endl;
+        return false;
+    }
+
+    for (addrinfo* entry = addresses; entry != nullptr; entry = entry->ai_next) {
+        m_socket = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+        if (m_socket == kInvalidSocket) {
+            continue;
+        }
+
+        int reuse = 1;
+        setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        if (bind(m_socket, entry->ai_addr, static_cast<int>(entry->ai_addrlen)) == 0 &&
+            listen(m_socket, SOMAXCONN) == 0) {
+            break;
+        }
+
+        CloseSocket(m_socket);
+        m_socket = kInvalidSocket;
+    }
+    freeaddrinfo(addresses);
+
+    if (m_socket == kInvalidSocket) {
+        std::wcerr << L"[ERROR] Could not listen on " << endpoint << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Accepts one connection
+bool NetChannel::Accept(NetChannel& connection, int timeoutSeconds) {
+    if (timeoutSeconds > 0) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(m_socket, &readable);
+        timeval timeout = {};
+        timeout.tv_sec = timeoutSeconds;
+
+        // The first argument is ignored by Winsock
+        if (select(static_cast<int>(m_socket) + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+            return false;
+        }
+    }
+
+    sockaddr_storage peer = {};
+    socklen_t peerSize = sizeof(peer);
+
+    SocketHandle socket = accept(m_socket, reinterpret_cast<sockaddr*>(&peer), &peerSize);
+    if (socket == kInvalidSocket) {
+        std::wcerr << L"[ERROR] Accepting a connection failed." << std::endl;
+        return false;
+    }
+
+    char host[NI_MAXHOST] = { 0 };
+    char service[NI_MAXSERV] = { 0 };
+    if (getnameinfo(reinterpret_cast<sockaddr*>(&peer), peerSize, host, sizeof(host),
+        service, sizeof(service), NI_NUMERICHOST | NI_NUMERICSERV) == 0) {
+        connection.m_peerName = UTF8ToWide(std::string(host) + ":" + service);
+    }
+
+    // Result frames are small and latency matters more than packet count
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    connection.Close();
+    connection.m_socket = socket;
+    return true;
+}
+
+// Connects to a listening channel
+bool NetChannel::Connect(const std::wstring& endpoint, int timeoutSeconds) {
+    std::string address;
+    std::string port;
+    if (!InitializeSockets() || !ParseEndpoint(endpoint, address, port) || address.empty()) {
+        std::wcerr << L"[ERROR] Invalid endpoint: " << endpoint << std::endl;
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeoutSeconds);
+
+    // The coordinator may still be enumerating the directory; keep retrying
+    for (;;) {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(address.c_str(), port.c_str(), &hints, &addresses) == 0) {
+            for (addrinfo* entry = addresses; entry != nullptr; entry = entry->ai_next) {
+                m_socket = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+                if (m_socket == kInvalidSocket) {
+                    continue;
+                }
+                if (connect(m_socket, entry->ai_addr, static_cast<int>(entry->ai_addrlen)) == 0) {
+                    break;
+                }
+                CloseSocket(m_socket);
+                m_socket = kInvalidSocket;
+            }
+            freeaddrinfo(addresses);
+        }
+
+        if (m_socket != kInvalidSocket) {
+            int noDelay = 1;
+            setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+            return true;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::wcerr << L"[ERROR] Could not connect to " << endpoint << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+}
+
+// Limits how long a receive or send may block
+void NetChannel::SetTimeouts(int receiveSeconds, int sendSeconds) {
+    if (m_socket == kInvalidSocket) {
+        return;
+    }
+    SetSocketTimeout(m_socket, SO_RCVTIMEO, receiveSeconds);
+    SetSocketTimeout(m_socket, SO_SNDTIMEO, sendSeconds);
+}
+
+// Authenticates every later frame
+void NetChannel::SetSessionKeys(const std::string& sendKey, const std::string& receiveKey) {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    m_sendKey = sendKey;
+    m_receiveKey = receiveKey;
+    m_sendSequence = 0;
+    m_receiveSequence = 0;
+}
+
+// Sends one frame
+bool NetChannel::SendFrame(uint8_t type, const std::string& payload) {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+
+    // The sequence number is taken under the lock, so frames go out in MAC order
+    std::string mac;
+    if (!m_sendKey.empty()) {
+        mac = Hmac::Sign(m_sendKey, MakeMacInput(m_sendSequence++, type, payload));
+    }
+
+    uint32_t length = static_cast<uint32_t>(payload.size() + 1 + mac.size());
+    char header[5] = {
+        static_cast<char>(length & 0xFF),
+        static_cast<char>((length >> 8) & 0xFF),
+        static_cast<char>((length >> 16) & 0xFF),
+        static_cast<char>((length >> 24) & 0xFF),
+        static_cast<char>(type)
+    };
+
+    return SendAll(header, sizeof(header)) && SendAll(payload.data(), payload.size()) &&
+        SendAll(mac.data(), mac.size());
+}
+
+// Receives one frame
+bool NetChannel::ReceiveFrame(uint8_t& type, std::string& payload) {
+    unsigned char header[5];
+    if (!ReceiveAll(reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+    }
+
+    uint32_t length = static_cast<uint32_t>(header[0]) | (static_cast<uint32_t>(header[1]) << 8) |
+        (static_cast<uint32_t>(header[2]) << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    // An unauthenticated peer must not be able to make this side allocate a large buffer
+    uint32_t maxLength = m_receiveKey.empty() ? kMaxHandshakeFrameSize : kMaxFrameSize;
+    if (length == 0 || length > maxLength) {
+        std::wcerr << L"[ERROR] Invalid frame from " << m_peerName << std::endl;
+        return false;
+    }
+
+    type = header[4];
+    payload.resize(length - 1);
+    if (!payload.empty() && !ReceiveAll(&payload[0], payload.size())) {
+        return false;
+    }
+
+    if (!m_receiveKey.empty()) {
+        size_t macOffset = payload.size() - std::min(payload.size(), Hmac::kDigestSize);
+        std::string mac = payload.substr(macOffset);
+        payload.resize(macOffset);
+
+        if (!Hmac::Equal(mac, Hmac::Sign(m_receiveKey, MakeMacInput(m_receiveSequence++, type, payload)))) {
+            std::wcerr << L"[ERROR] Frame from " << m_peerName << L" failed authentication; closing the connection." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Closes the connection
+void NetChannel::Close() {
+    if (m_socket != kInvalidSocket) {
+        CloseSocket(m_socket);
+        m_socket = kInvalidSocket;
+    }
+}
+
+// Splits "[address:]port"
+bool NetChannel::ParseEndpoint(const std::wstring& endpoint, std::string& address, std::string& port) {
+    std::string text = WideToUTF8(endpoint);
+    size_t colon = text.rfind(':');
+
+    address = colon == std::string::npos ? "" : text.substr(0, colon);
+    port = colon == std::string::npos ? text : text.substr(colon + 1);
+
+    // "[::1]:9000" style IPv6 literals
+    if (address.size() >= 2 && address.front() == '[' && address.back() == ']') {
+        address = address.substr(1, address.size() - 2);
+    }
+
+    return !port.empty() && port.find_first_not_of("0123456789") == std::string::npos;
+}
+
+// Writes the whole buffer
+bool NetChannel::SendAll(const char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(size > (1u << 30) ? (1u << 30) : size);
+#ifdef _WIN32
+        int sent = send(m_socket, data, chunk, 0);
+#else
+        int sent = static_cast<int>(send(m_socket, data, chunk, MSG_NOSIGNAL));
+#endif
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+// Reads exactly size bytes
+bool NetChannel::ReceiveAll(char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(size > (1u << 30) ? (1u << 30) : size);
+        int received = static_cast<int>(recv(m_socket, data, chunk, 0));
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= received;
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+#ifndef NETCHANNEL_H
+#define NETCHANNEL_H
+
+#include <string>
+#include <cstdint>
+#include <mutex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+using SocketHandle = SOCKET;
+#else
+using SocketHandle = int;
+#endif
+
+/**
+ * @class NetChannel
+ * @brief TCP connection carrying length-prefixed message frames
+ *
+ * A frame is a 4-byte little-endian length, a 1-byte message type and the
+ * payload. Sends are serialized so several threads can share one channel.
+ * Once session keys are set, each frame also ends in an HMAC-SHA256 over
+ * a per-direction sequence number, the type and the payload. Until then,
+ * frames are limited to a few KB.
+ */
+class NetChannel {
+public:
+    NetChannel();
+    ~NetChannel();
+
+    NetChannel(const NetChannel&) = delete;
+    NetChannel& operator=(const NetChannel&) = delete;
+
+    /**
+     * @brief Starts listening for connections
+     * @param endpoint "[address:]port" (address defaults to loopback; 0.0.0.0 or [::] for all interfaces)
+     * @return True if successful
+     */
+    bool Listen(const std::wstring& endpoint);
+
+    /**
+     * @brief Waits for one connection on a listening channel
+     * @param connection Receives the accepted connection
+     * @param timeoutSeconds How long to wait (0 = no limit)
+     * @return False on error or if no connection arrived in time
+     */
+    bool Accept(NetChannel& connection, int timeoutSeconds = 0);
+
+    /**
+     * @brief Connects to a listening channel, retrying until it is available
+     * @param endpoint "address:port"
+     * @param timeoutSeconds How long to keep retrying
+     * @return True if successful
+     */
+    bool Connect(const std::wstring& endpoint, int timeoutSeconds);
+
+    /**
+     * @brief Limits how long a receive or send may block; a timed-out transfer fails the connection
+     * @param receiveSeconds Receive timeout (0 = no limit)
+     * @param sendSeconds Send timeout (0 = no limit)
+     */
+    void SetTimeouts(int receiveSeconds, int sendSeconds);
+
+    /**
+     * @brief Authenticates every later frame in both directions
+     *
+     * A frame that was changed, injected, replayed or reordered fails the
+     * MAC check and the connection. Both ends switch after the same frame
+     * of the handshake.
+     *
+     * @param sendKey Key of the frames this side sends
+     * @param receiveKey Key of the frames the peer sends
+     */
+    void SetSessionKeys(const std::string& sendKey, const std::string& receiveKey);
+
+    /**
+     * @brief Sends one frame (thread-safe)
+     * @return False if the connection failed
+     */
+    bool SendFrame(uint8_t type, const std::string& payload);
+
+    /**
+     * @brief Receives one frame (one reader at a time)
+     * @return False if the connection was closed or failed
+     */
+    bool ReceiveFrame(uint8_t& type, std::string& payload);
+
+    /**
+     * @brief Closes the connection
+     */
+    void Close();
+
+    /**
+     * @brief Returns the peer address of an accepted connection
+     */
+    const std::wstring& GetPeerName() const { return m_peerName; }
+
+private:
+    SocketHandle m_socket;      // Socket (invalid when closed)
+    std::mutex m_sendMutex;     // Serializes SendFrame and m_sendSequence
+    std::wstring m_peerName;    // Remote address
+    std::string m_sendKey;      // MAC key of sent frames (empty = no MAC)
+    std::string m_receiveKey;   // MAC key of received frames (empty = no MAC)
+    uint64_t m_sendSequence;    // Sequence number of the next sent frame
+    uint64_t m_receiveSequence; // Sequence number of the next received frame
+
+    /**
+     * @brief Splits "[address:]port"
+     */
+    static bool ParseEndpoint(const std::wstring& endpoint, std::string& address, std::string& port);
+
+    bool SendAll(const char* data, size_t size);
+    bool ReceiveAll(char* data, size_t size);
+};
+
+#endif // NETCHANNEL_H
@@ -0,0 +1,162 @@
+#include "Platform.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdlib>
+#include <cstdio>
+#endif
+
+namespace {
+
+    const char32_t kReplacementChar = 0xFFFD;
+
+    void AppendCodePoint(std::string& out, char32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        }
+        else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    void AppendWide(std::wstring& out, char32_t cp) {
+        if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+            cp -= 0x10000;
+            out += static_cast<wchar_t>(0xD800 + (cp >> 10));
+            out += static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+        }
+        else {
+            out += static_cast<wchar_t>(cp);
+        }
+    }
+}
+
+// Converts a wide string to UTF-8
+std::string WideToUTF8(const std::wstring& wstr) {
+    std::string result;
+    result.reserve(wstr.size());
+
+    for (size_t i = 0; i < wstr.size(); ++i) {
+        char32_t cp = static_cast<char32_t>(wstr[i]);
+
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            // High surrogate: combine with the following low surrogate
+            if (i + 1 < wstr.size() && wstr[i + 1] >= 0xDC00 && wstr[i + 1] <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<char32_t>(wstr[++i]) - 0xDC00);
+            }
+            else {
+                cp = kReplacementChar;
+            }
+        }
+        else if ((cp >= 0xDC00 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            cp = kReplacementChar;
+        }
+
+        AppendCodePoint(result, cp);
+    }
+
+    return result;
+}
+
+// Converts a UTF-8 string to a wide string
+std::wstring UTF8ToWide(const std::string& str) {
+    std::wstring result;
+    result.reserve(str.size());
+
+    size_t i = 0;
+    while (i < str.size()) {
+        unsigned char lead = static_cast<unsigned char>(str[i]);
+        size_t length = 0;
+        char32_t cp = 0;
+
+        if (lead < 0x80) {
+            length = 1;
+            cp = lead;
+        }
+        else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            cp = lead & 0x1F;
+        }
+        else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            cp = lead & 0x0F;
+        }
+        else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            cp = lead & 0x07;
+        }
+
+        bool valid = length > 0 && i + length <= str.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            unsigned char next = static_cast<unsigned char>(str[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                valid = false;
+            }
+            cp = (cp << 6) | (next & 0x3F);
+        }
+
+        // Reject overlong forms, surrogates and out-of-range values
+        static const char32_t minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+        if (valid && (cp < minimum[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))) {
+            valid = false;
+        }
+
+        if (!valid) {
+            AppendWide(result, kReplacementChar);
+            i += 1;
+            continue;
+        }
+
+        AppendWide(result, cp);
+        i += length;
+    }
+
+    return result;
+}
+
+// Returns the value of an environment variable
+std::string GetEnvironmentValue(const wchar_t* name) {
+#ifdef _WIN32
+    DWORD size = GetEnvironmentVariableW(name, nullptr, 0);
+    if (size == 0) {
+        return std::string();
+    }
+    std::wstring value(size, L'\0');
+    size = GetEnvironmentVariableW(name, &value[0], size);
+    value.resize(size);
+    return WideToUTF8(value);
+#else
+    const char* value = std::getenv(WideToUTF8(name).c_str());
+    return value ? std::string(value) : std::string();
+#endif
+}
+
+// Renames a file over another one
+bool ReplaceWithFile(const std::wstring& source, const std::wstring& target) {
+#ifdef _WIN32
+    return MoveFileExW(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(WideToUTF8(source).c_str(), WideToUTF8(target).c_str()) == 0;
+#endif
+}
+
+// Deletes a file
+bool RemoveFile(const std::wstring& path) {
+#ifdef _WIN32
+    return DeleteFileW(path.c_str()) != 0;
+#else
+    return std::remove(WideToUTF8(path).c_str()) == 0;
+#endif
+}
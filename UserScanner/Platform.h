@@ -0,0 +1,50 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <string>
+
+/**
+ * @brief Converts a wide string (UTF-16 on Windows, UTF-32 elsewhere) to UTF-8
+ * @param wstr Wide-character string
+ * @return UTF-8 encoded string (invalid code units become U+FFFD)
+ */
+std::string WideToUTF8(const std::wstring& wstr);
+
+/**
+ * @brief Converts a UTF-8 string to a wide string
+ * @param str UTF-8 encoded string
+ * @return Wide-character string (invalid sequences become U+FFFD)
+ */
+std::wstring UTF8ToWide(const std::string& str);
+
+/**
+ * @brief Returns the value of an environment variable as UTF-8
+ * @param name Variable name
+ * @return Value ("" if the variable is not set)
+ */
+std::string GetEnvironmentValue(const wchar_t* name);
+
+/**
+ * @brief Renames a file over another one, replacing it if it exists
+ * @param source File to rename
+ * @param target Path the file takes
+ * @return True if successful
+ */
+bool ReplaceWithFile(const std::wstring& source, const std::wstring& target);
+
+/**
+ * @brief Deletes a file
+ * @return True if the file was deleted
+ */
+bool RemoveFile(const std::wstring& path);
+
+/**
+ * @brief Converts a path to the form accepted by the file streams of the platform
+ */
+#ifdef _WIN32
+inline const std::wstring& ToNativePath(const std::wstring& path) { return path; }
+#else
+inline std::string ToNativePath(const std::wstring& path) { return WideToUTF8(path); }
+#endif
+
+#endif // PLATFORM_H
@@ -0,0 +1,79 @@
+#include "ProbeStatus.h"
+#include "DnsResolver.h"
+
+namespace {
+
+    const long kErrorAccessDenied = 5;              // ERROR_ACCESS_DENIED
+    const long kErrorBadNetPath = 53;               // ERROR_BAD_NETPATH
+    const long kErrorNetNameDeleted = 64;           // ERROR_NETNAME_DELETED
+    const long kErrorBadNetName = 67;               // ERROR_BAD_NET_NAME
+    const long kErrorSemTimeout = 121;              // ERROR_SEM_TIMEOUT
+    const long kWaitTimeout = 258;                  // WAIT_TIMEOUT
+    const long kErrorNotEnoughServerMemory = 1130;  // ERROR_NOT_ENOUGH_SERVER_MEMORY
+    const long kErrorNoNetOrBadPath = 1203;         // ERROR_NO_NET_OR_BAD_PATH
+    const long kErrorNetworkUnreachable = 1231;     // ERROR_NETWORK_UNREACHABLE
+    const long kErrorHostUnreachable = 1232;        // ERROR_HOST_UNREACHABLE
+    const long kErrorConnectionAborted = 1236;      // ERROR_CONNECTION_ABORTED
+    const long kErrorNoSystemResources = 1450;      // ERROR_NO_SYSTEM_RESOURCES
+    const long kErrorTimeout = 1460;                // ERROR_TIMEOUT
+    const long kRpcServerUnavailable = 1722;        // RPC_S_SERVER_UNAVAILABLE
+    const long kRpcServerTooBusy = 1723;            // RPC_S_SERVER_TOO_BUSY
+    const long kRpcCallFailed = 1726;               // RPC_S_CALL_FAILED
+    const long kRpcCallCancelled = 1818;            // RPC_S_CALL_CANCELLED
+
+    const char* const kStatusNames[] = {
+        "OK",
+        "TIMEOUT",
+        "BUSY",
+        "ACCESS_DENIED",
+        "UNREACHABLE",
+        "NOT_FOUND",
+        "ERROR",
+    };
+}
+
+// Maps a Win32 error code to a status
+ProbeStatus ClassifyProbeError(long errorCode) {
+    switch (errorCode) {
+    case 0:
+        return ProbeStatus::Ok;
+    case kErrorSemTimeout:
+    case kWaitTimeout:
+    case kErrorTimeout:
+        return ProbeStatus::Timeout;
+    case kRpcServerTooBusy:
+    case kRpcCallFailed:
+    case kRpcCallCancelled:
+    case kErrorNetNameDeleted:
+    case kErrorConnectionAborted:
+    case kErrorNotEnoughServerMemory:
+    case kErrorNoSystemResources:
+        return ProbeStatus::Busy;
+    case kErrorAccessDenied:
+        return ProbeStatus::AccessDenied;
+    case kErrorBadNetPath:
+    case kErrorBadNetName:
+    case kErrorNoNetOrBadPath:
+    case kErrorNetworkUnreachable:
+    case kErrorHostUnreachable:
+    case kRpcServerUnavailable:
+        return ProbeStatus::Unreachable;
+    case DnsResolver::kHostNotFound:
+        return ProbeStatus::NotFound;
+    default:
+        return ProbeStatus::Error;
+    }
+}
+
+// Returns true for failures worth retrying
+bool IsTransient(ProbeStatus status) {
+    return status == ProbeStatus::Timeout ||
+        status == ProbeStatus::Busy ||
+        status == ProbeStatus::AccessDenied;
+}
+
+// Returns the report name of a status
+const char* GetStatusName(ProbeStatus status) {
+    int index = static_cast<int>(status);
+    return index >= 0 && index < static_cast<int>(ProbeStatus::Count) ? kStatusNames[index] : "ERROR";
+}
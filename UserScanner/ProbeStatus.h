@@ -0,0 +1,35 @@
+#ifndef PROBESTATUS_H
+#define PROBESTATUS_H
+
+/**
+ * @enum ProbeStatus
+ * @brief Classified result of probing one host, as written to the report
+ */
+enum class ProbeStatus {
+    Ok = 0,             // Registry connection succeeded
+    Timeout = 1,        // Host did not answer in time (transient)
+    Busy = 2,           // RPC server busy or connection dropped (transient)
+    AccessDenied = 3,   // Access denied, e.g. during a policy refresh (transient)
+    Unreachable = 4,    // Network path not found, host unreachable or RPC server unavailable
+    NotFound = 5,       // Name does not resolve
+    Error = 6,          // Any other failure
+    Count = 7
+};
+
+/**
+ * @brief Maps a Win32 error code from the registry connection to a status
+ * @param errorCode Error code (0 = success)
+ */
+ProbeStatus ClassifyProbeError(long errorCode);
+
+/**
+ * @brief Returns true for failures that may succeed when the host is probed again later
+ */
+bool IsTransient(ProbeStatus status);
+
+/**
+ * @brief Returns the name of a status as written to the report (e.g. "TIMEOUT")
+ */
+const char* GetStatusName(ProbeStatus status);
+
+#endif // PROBESTATUS_H
@@ -0,0 +1,171 @@
+#include "ProgressReporter.h"
+#include "Platform.h"
+#include "ProbeStatus.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // Interval between progress updates
+    const std::chrono::seconds kTickInterval(1);
+
+    // Weight of the newest sample in the smoothed rate (about a 5 s horizon)
+    const double kEwmaAlpha = 0.2;
+
+    std::wstring FormatDuration(double seconds) {
+        if (seconds < 0 || !std::isfinite(seconds)) {
+            return L"--:--:--";
+        }
+
+        long long total = static_cast<long long>(seconds + 0.5);
+        std::wostringstream ss;
+        ss << std::setfill(L'0') << std::setw(2) << (total / 3600) << L":"
+            << std::setw(2) << ((total / 60) % 60) << L":"
+            << std::setw(2) << (total % 60);
+        return ss.str();
+    }
+}
+
+// Constructor
+ProgressReporter::ProgressReporter(size_t totalHosts, const std::wstring& progressFile)
+    : m_totalHosts(totalHosts)
+    , m_progressFile(progressFile)
+    , m_stopping(false)
+    , m_interactive(isatty(fileno(stdout)) != 0)
+    , m_lastDone(0)
+    , m_ewmaRate(0.0)
+{
+    for (auto& counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+// Destructor
+ProgressReporter::~ProgressReporter() {
+    Stop();
+}
+
+// Starts the reporter thread
+bool ProgressReporter::Start() {
+    if (!m_progressFile.empty() && m_progressFile != L"-") {
+        m_progressStream.open(ToNativePath(m_progressFile), std::ios::out | std::ios::trunc);
+        if (!m_progressStream.is_open()) {
+            std::wcerr << L"[ERROR] Could not open progress file: " << m_progressFile << std::endl;
+            return false;
+        }
+    }
+
+    m_startTime = Clock::now();
+    m_lastTick = m_startTime;
+    m_stopping = false;
+    m_thread = std::thread(&ProgressReporter::ReportLoop, this);
+    return true;
+}
+
+// Stops the reporter thread
+void ProgressReporter::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+
+    Tick(true);
+    m_progressStream.close();
+}
+
+// Maps a registry connection error code to an outcome
+ProbeOutcome ProgressReporter::Classify(long errorCode) {
+    switch (ClassifyProbeError(errorCode)) {
+    case ProbeStatus::Ok:
+        return ProbeOutcome::Reachable;
+    case ProbeStatus::Timeout:
+        return ProbeOutcome::Timeout;
+    default:
+        return ProbeOutcome::Error;
+    }
+}
+
+// Reporter thread body
+void ProgressReporter::ReportLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_cv.wait_for(lock, kTickInterval, [this] { return m_stopping; })) {
+        lock.unlock();
+        Tick(false);
+        lock.lock();
+    }
+}
+
+// Prints one progress update
+void ProgressReporter::Tick(bool final) {
+    uint64_t reachable = m_counters[static_cast<int>(ProbeOutcome::Reachable)].load(std::memory_order_relaxed);
+    uint64_t timeouts = m_counters[static_cast<int>(ProbeOutcome::Timeout)].load(std::memory_order_relaxed);
+    uint64_t errors = m_counters[static_cast<int>(ProbeOutcome::Error)].load(std::memory_order_relaxed);
+    uint64_t done = reachable + timeouts + errors;
+
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_startTime).count();
+    double interval = std::chrono::duration<double>(now - m_lastTick).count();
+
+    double rate = interval > 0 ? (done - m_lastDone) / interval : 0.0;
+    m_ewmaRate = (m_lastDone == 0 && m_ewmaRate == 0.0) ? rate : kEwmaAlpha * rate + (1.0 - kEwmaAlpha) * m_ewmaRate;
+    m_lastDone = done;
+    m_lastTick = now;
+
+    double remaining = static_cast<double>(m_totalHosts > done ? m_totalHosts - done : 0);
+    double eta = final ? 0.0 : (m_ewmaRate > 0 ? remaining / m_ewmaRate : -1.0);
+    double percent = m_totalHosts > 0 ? 100.0 * done / m_totalHosts : 100.0;
+
+    std::wostringstream line;
+    line << std::fixed << std::setprecision(1)
+        << L"[PROGRESS] " << done << L"/" << m_totalHosts << L" (" << percent << L"%)"
+        << L" | " << rate << L" hosts/s (avg " << m_ewmaRate << L")"
+        << L" | ok " << reachable << L", timeout " << timeouts << L", error " << errors
+        << L" | " << (final ? L"elapsed " + FormatDuration(elapsed) : L"ETA " + FormatDuration(eta));
+
+    if (m_interactive && !final) {
+        // Overwrite the same console line; pad to clear a longer previous line
+        std::wcout << L"\r" << std::left << std::setw(110) << line.str() << std::flush;
+    }
+    else {
+        std::wcout << (m_interactive ? L"\r" : L"") << line.str() << std::endl;
+    }
+
+    if (!m_progressFile.empty()) {
+        char json[512];
+        snprintf(json, sizeof(json),
+            "{\"elapsed\":%.1f,\"done\":%llu,\"total\":%llu,\"reachable\":%llu,\"timeout\":%llu,"
+            "\"error\":%llu,\"rate\":%.2f,\"ewma_rate\":%.2f,\"eta_seconds\":%.0f,\"final\":%s}",
+            elapsed,
+            static_cast<unsigned long long>(done),
+            static_cast<unsigned long long>(m_totalHosts),
+            static_cast<unsigned long long>(reachable),
+            static_cast<unsigned long long>(timeouts),
+            static_cast<unsigned long long>(errors),
+            rate, m_ewmaRate, eta, final ? "true" : "false");
+
+        if (m_progressStream.is_open()) {
+            m_progressStream << json << "\n" << std::flush;
+        }
+        else {
+            std::string text(json);
+            std::wcerr << std::wstring(text.begin(), text.end()) << std::endl;
+        }
+    }
+}
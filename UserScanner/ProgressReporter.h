@@ -0,0 +1,105 @@
+#ifndef PROGRESSREPORTER_H
+#define PROGRESSREPORTER_H
+
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @enum ProbeOutcome
+ * @brief Coarse result of probing one host, as counted by the progress reporter
+ */
+enum class ProbeOutcome {
+    Reachable = 0,      // Registry connection succeeded
+    Timeout = 1,        // Host did not answer in time
+    Error = 2,          // Any other failure
+    Count = 3
+};
+
+/**
+ * @class ProgressReporter
+ * @brief Prints scan progress from a single reporter thread
+ *
+ * Scan threads only call RecordHost(), which is one relaxed atomic
+ * increment. Once per interval the reporter thread reads the counters and
+ * prints done/total, the instantaneous and smoothed host rate, the outcome
+ * split and an ETA. It can also append a JSON line per tick to a file for
+ * wrapper scripts.
+ */
+class ProgressReporter {
+public:
+    /**
+     * @brief Constructs the reporter
+     * @param totalHosts Number of hosts that will be scanned
+     * @param progressFile JSON-lines output path ("-" for stderr, empty for none)
+     */
+    ProgressReporter(size_t totalHosts, const std::wstring& progressFile);
+
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    /**
+     * @brief Starts the reporter thread
+     * @return True if successful (false if the progress file could not be opened)
+     */
+    bool Start();
+
+    /**
+     * @brief Stops the reporter thread and prints the final state
+     */
+    void Stop();
+
+    /**
+     * @brief Counts one finished host (thread-safe, lock-free)
+     * @param outcome Result of the probe
+     */
+    void RecordHost(ProbeOutcome outcome) {
+        m_counters[static_cast<int>(outcome)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Maps a Win32 error code from the registry connection to an outcome
+     * @param errorCode Error code (0 = success)
+     */
+    static ProbeOutcome Classify(long errorCode);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    size_t m_totalHosts;                // Hosts to scan
+    std::wstring m_progressFile;        // JSON-lines output path
+    std::ofstream m_progressStream;     // JSON-lines output (file mode)
+    std::thread m_thread;               // Reporter thread
+    std::mutex m_mutex;                 // Protects m_stopping
+    std::condition_variable m_cv;       // Wakes the reporter on Stop()
+    bool m_stopping;                    // Stop requested
+    bool m_interactive;                 // Console is a terminal (overwrite the line)
+
+    std::atomic<uint64_t> m_counters[static_cast<int>(ProbeOutcome::Count)];
+
+    // Reporter thread state
+    Clock::time_point m_startTime;      // Scan start
+    Clock::time_point m_lastTick;       // Previous tick
+    uint64_t m_lastDone;                // Hosts done at the previous tick
+    double m_ewmaRate;                  // Smoothed hosts/sec
+
+    /**
+     * @brief Reporter thread body
+     */
+    void ReportLoop();
+
+    /**
+     * @brief Reads the counters and prints one progress update
+     * @param final True for the last update after the scan finished
+     */
+    void Tick(bool final);
+};
+
+#endif // PROGRESSREPORTER_H
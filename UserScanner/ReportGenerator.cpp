@@ -1,15 +1,22 @@
 #include "ReportGenerator.h"
+#include "Platform.h"
+#include "CsvEncoder.h"
 #include <iostream>
 #include <codecvt>
 #include <locale>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 // Constructor
-ReportGenerator::ReportGenerator(const std::wstring& outputPath)
+ReportGenerator::ReportGenerator(const std::wstring& outputPath, const CompressionOptions& compression)
     : m_outputPath(outputPath)
+    , m_compression(compression)
     , m_totalComputers(0)
     , m_computersWithUsers(0)
     , m_totalUsers(0)
+    , m_statusCounts()
+    , m_bytesWritten(0)
 {
 }
 
@@ -20,39 +27,52 @@ ReportGenerator::~ReportGenerator() {
 
 // Initializes the report file
 bool ReportGenerator::Initialize() {
-    // Open file in UTF-8 mode
-    m_outputFile.open(m_outputPath, std::ios::out | std::ios::trunc);
+    if (m_compression.enabled) {
+        // Rows are collected into blocks and compressed on a background thread
+        m_compressor = std::make_unique<CompressedWriter>(m_outputPath, m_compression);
+        if (!m_compressor->Open()) {
+            m_compressor.reset();
+            return false;
+        }
+        m_pendingBlock.reserve(m_compression.frameSize);
+    }
+    else {
+        // Open file in UTF-8 mode
+        m_outputFile.open(ToNativePath(m_outputPath), std::ios::out | std::ios::trunc);
 
-    if (!m_outputFile.is_open()) {
-        std::wcerr << L"[ERROR] Could not open output file: " << m_outputPath << std::endl;
-        return false;
+        if (!m_outputFile.is_open()) {
+            std::wcerr << L"[ERROR] Could not open output file: " << m_outputPath << std::endl;
+            return false;
+        }
     }
 
     // Add UTF-8 BOM (required for Excel)
-    m_outputFile << "\xEF\xBB\xBF";
+    WriteOutput("\xEF\xBB\xBF");
 
     // CSV header row
-    m_outputFile << "Computer,OS,SID,Logon User\n";
-    m_outputFile.flush();
+    WriteOutput("Computer,OS,SID,Logon User,Status\n");
+
+    if (m_outputFile.is_open()) {
+        m_outputFile.flush();
+    }
 
-    std::wcout << L"[INFO] Report file created: " << m_outputPath << std::endl;
+    std::wcout << L"[INFO] Report file created: " << m_outputPath
+        << (m_compressor ? L" (gzip)" : L"") << std::endl;
     return true;
 }
 
 // Adds computer and user information to the report
-void ReportGenerator::AddEntry(const ComputerInfo& computer, const std::vector<UserInfo>& users) {
+void ReportGenerator::AddEntry(const ComputerInfo& computer, const std::vector<UserInfo>& users,
+    ProbeStatus status) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
     m_totalComputers++;
+    m_statusCounts[static_cast<int>(status)]++;
+    m_rowBuffer.clear();
 
     if (users.empty()) {
         // If no users, write only computer info
-        std::wstring line = computer.hostname + L"," +
-            EscapeCSV(computer.operatingSystem) + L"," +
-            L"," +
-            L"\n";
-
-        m_outputFile << WStringToUTF8(line);
+        AppendRow(m_rowBuffer, computer, nullptr, status);
     }
     else {
         // Each user gets a separate row
@@ -60,30 +80,106 @@ void ReportGenerator::AddEntry(const ComputerInfo& computer, const std::vector<U
 
         for (const auto& user : users) {
             m_totalUsers++;
+            AppendRow(m_rowBuffer, computer, &user, status);
+        }
+    }
 
-            std::wstring line = computer.hostname + L"," +
-                EscapeCSV(computer.operatingSystem) + L"," +
-                user.sid + L"," +
-                L"\"" + user.GetFullName() + L"\"" +
-                L"\n";
+    WriteOutput(m_rowBuffer);
 
-            m_outputFile << WStringToUTF8(line);
-        }
+    // Compressed output is flushed in whole blocks by the compression thread
+    if (m_outputFile.is_open()) {
+        m_outputFile.flush();
     }
+}
 
-    m_outputFile.flush();
+// Appends one CSV row to a buffer
+void ReportGenerator::AppendRow(std::string& out, const ComputerInfo& computer, const UserInfo* user,
+    ProbeStatus status) {
+    CsvEncoder::AppendField(out, computer.hostname);
+    out += ',';
+    CsvEncoder::AppendField(out, computer.operatingSystem);
+    out += ',';
+
+    if (user) {
+        CsvEncoder::AppendField(out, user->sid);
+        out += ',';
+
+        // DOMAIN\Username, always quoted
+        size_t start = out.size();
+        CsvEncoder::AppendUTF8(out, user->domainName);
+        out += '\\';
+        CsvEncoder::AppendUTF8(out, user->userName);
+        CsvEncoder::QuoteInPlace(out, start);
+    }
+    else {
+        out += ',';
+    }
+
+    // Status names are plain ASCII and never need quoting
+    out += ',';
+    out += GetStatusName(status);
+    out += '\n';
+}
+
+// Appends UTF-8 data to the output
+void ReportGenerator::WriteOutput(const std::string& data) {
+    m_bytesWritten += data.size();
+
+    if (!m_compressor) {
+        m_outputFile.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return;
+    }
+
+    m_pendingBlock += data;
+
+    // Hand over full blocks so the compressor works on large inputs
+    if (m_pendingBlock.size() >= m_compression.frameSize) {
+        m_compressor->Write(std::move(m_pendingBlock));
+        m_pendingBlock = std::string();
+        m_pendingBlock.reserve(m_compression.frameSize);
+    }
 }
 
 // Closes the report file
 void ReportGenerator::Close() {
-    if (m_outputFile.is_open()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_compressor && !m_outputFile.is_open()) {
+        return;
+    }
+
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+
+    if (m_compressor) {
+        // Hand over the last partial block and finish the gzip stream
+        m_compressor->Write(std::move(m_pendingBlock));
+        m_pendingBlock.clear();
+
+        if (!m_compressor->Close()) {
+            std::wcerr << L"[ERROR] Compressed report may be incomplete: " << m_outputPath << std::endl;
+        }
+        bytesIn = m_compressor->GetBytesIn();
+        bytesOut = m_compressor->GetBytesOut();
+        m_compressor.reset();
+    }
+    else {
         m_outputFile.close();
+    }
 
-        std::wcout << L"\n=== REPORT SUMMARY ===" << std::endl;
-        std::wcout << L"Total computers: " << m_totalComputers << std::endl;
-        std::wcout << L"Computers with users: " << m_computersWithUsers << std::endl;
-        std::wcout << L"Total logons: " << m_totalUsers << std::endl;
-        std::wcout << L"Report file: " << m_outputPath << std::endl;
+    std::wcout << L"\n=== REPORT SUMMARY ===" << std::endl;
+    std::wcout << L"Total computers: " << m_totalComputers << std::endl;
+    std::wcout << L"Computers with users: " << m_computersWithUsers << std::endl;
+    std::wcout << L"Total logons: " << m_totalUsers << std::endl;
+    for (int i = static_cast<int>(ProbeStatus::Ok) + 1; i < static_cast<int>(ProbeStatus::Count); ++i) {
+        if (m_statusCounts[i] > 0) {
+            std::wcout << L"Status " << GetStatusName(static_cast<ProbeStatus>(i)) << L": "
+                << m_statusCounts[i] << L" computers" << std::endl;
+        }
+    }
+    std::wcout << L"Report file: " << m_outputPath << std::endl;
+    if (bytesIn > 0) {
+        std::wcout << L"Compressed size: " << bytesOut << L" of " << bytesIn << L" bytes" << std::endl;
     }
 }
 
@@ -93,6 +189,9 @@ std::string ReportGenerator::WStringToUTF8(const std::wstring& wstr) {
         return std::string();
     }
 
+#ifndef _WIN32
+    return WideToUTF8(wstr);
+#else
     // Use Windows API for conversion
     int sizeNeeded = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1,
         nullptr, 0, nullptr, nullptr);
@@ -110,14 +209,16 @@ std::string ReportGenerator::WStringToUTF8(const std::wstring& wstr) {
     }
 
     return result;
+#endif
 }
 
 // Escapes a string for CSV
 std::wstring ReportGenerator::EscapeCSV(const std::wstring& str) {
-    // If contains comma, quote, or newline, wrap in quotes and double the quotes
+    // If contains comma, quote, or line break, wrap in quotes and double the quotes
     if (str.find(L',') != std::wstring::npos ||
         str.find(L'"') != std::wstring::npos ||
-        str.find(L'\n') != std::wstring::npos) {
+        str.find(L'\n') != std::wstring::npos ||
+        str.find(L'\r') != std::wstring::npos) {
 
         std::wstring escaped = L"\"";
         for (wchar_t ch : str) {
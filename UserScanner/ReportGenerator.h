@@ -2,9 +2,13 @@
 #define REPORTGENERATOR_H
 
 #include "ADHelper.h"
+#include "CompressedWriter.h"
+#include "ProbeStatus.h"
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <memory>
+#include <cstdint>
 
 /**
  * @class ReportGenerator
@@ -15,8 +19,10 @@ public:
     /**
      * @brief Constructs the report generator
      * @param outputPath Path of the output file
+     * @param compression Compressed output settings (disabled by default)
      */
-    explicit ReportGenerator(const std::wstring& outputPath);
+    explicit ReportGenerator(const std::wstring& outputPath,
+        const CompressionOptions& compression = CompressionOptions());
 
     ~ReportGenerator();
 
@@ -30,8 +36,10 @@ public:
      * @brief Adds computer and user information to the report (thread-safe)
      * @param computer Computer information
      * @param users List of users
+     * @param status Classified probe result, written to the Status column
      */
-    void AddEntry(const ComputerInfo& computer, const std::vector<UserInfo>& users);
+    void AddEntry(const ComputerInfo& computer, const std::vector<UserInfo>& users,
+        ProbeStatus status = ProbeStatus::Ok);
 
     /**
      * @brief Returns statistics
@@ -39,33 +47,56 @@ public:
     int GetTotalComputers() const { return m_totalComputers; }
     int GetComputersWithUsers() const { return m_computersWithUsers; }
     int GetTotalUsers() const { return m_totalUsers; }
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
 
     /**
      * @brief Closes the report file
      */
     void Close();
 
-private:
-    std::wstring m_outputPath;      // Output file path
-    std::ofstream m_outputFile;     // Output file stream
-    std::mutex m_mutex;             // Mutex for thread safety
-    int m_totalComputers;           // Total number of computers
-    int m_computersWithUsers;       // Number of computers with users
-    int m_totalUsers;               // Total number of users
+    /**
+     * @brief Appends one CSV row to a buffer without intermediate allocations
+     * @param out Output buffer (UTF-8)
+     * @param computer Computer information
+     * @param user User of the row (nullptr for a computer without users)
+     * @param status Classified probe result
+     */
+    static void AppendRow(std::string& out, const ComputerInfo& computer, const UserInfo* user,
+        ProbeStatus status = ProbeStatus::Ok);
 
     /**
-     * @brief Converts a wstring to a UTF-8 string
+     * @brief Converts a wstring to a UTF-8 string (reference conversion)
      * @param wstr Wide-character string
      * @return UTF-8 encoded string
      */
     static std::string WStringToUTF8(const std::wstring& wstr);
 
     /**
-     * @brief Escapes a string for CSV (handles commas and quotes)
+     * @brief Escapes a string for CSV (reference implementation; quotes on comma, quote, CR or LF)
      * @param str Input string
      * @return Escaped string
      */
     static std::wstring EscapeCSV(const std::wstring& str);
+
+private:
+    std::wstring m_outputPath;      // Output file path
+    std::ofstream m_outputFile;     // Output file stream
+    CompressionOptions m_compression;               // Compressed output settings
+    std::unique_ptr<CompressedWriter> m_compressor; // Compression thread (compressed mode only)
+    std::string m_pendingBlock;     // Rows waiting to be handed to the compressor
+    std::string m_rowBuffer;        // Reused buffer for the rows of one entry
+    std::mutex m_mutex;             // Mutex for thread safety
+    int m_totalComputers;           // Total number of computers
+    int m_computersWithUsers;       // Number of computers with users
+    int m_totalUsers;               // Total number of users
+    int m_statusCounts[static_cast<int>(ProbeStatus::Count)];   // Computers per probe status
+    uint64_t m_bytesWritten;        // UTF-8 bytes written (before compression)
+
+    /**
+     * @brief Appends UTF-8 data to the output (file or compressor)
+     * @param data UTF-8 encoded data
+     */
+    void WriteOutput(const std::string& data);
 };
 
 #endif // REPORTGENERATOR_H
@@ -0,0 +1,98 @@
+#include "RetryQueue.h"
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+// Constructor
+RetryQueue::RetryQueue(const RetryOptions& options)
+    : m_options(options)
+    , m_rng(std::random_device()())
+    , m_running(0)
+    , m_deferredHosts(0)
+    , m_recoveredHosts(0)
+{
+}
+
+// Schedules a host for another attempt
+bool RetryQueue::Defer(size_t index, int failures) {
+    if (failures > m_options.maxRetries) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Exponential backoff with jitter: a random point in the upper half of the delay
+    double delay = std::min(m_options.maxDelaySeconds,
+        m_options.baseDelaySeconds * std::pow(2.0, failures - 1));
+    delay *= std::uniform_real_distribution<double>(0.5, 1.0)(m_rng);
+
+    Entry entry;
+    entry.due = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(delay));
+    entry.index = index;
+    entry.failures = failures;
+
+    m_heap.push_back(entry);
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+
+    if (failures == 1) {
+        m_deferredHosts++;
+    }
+
+    m_cv.notify_all();
+    return true;
+}
+
+// Takes the next deferred host once it is due
+bool RetryQueue::Next(size_t& index, int& failures) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;) {
+        if (m_heap.empty()) {
+            // A running retry may still defer its host again
+            if (m_running == 0) {
+                return false;
+            }
+            m_cv.wait(lock);
+            continue;
+        }
+
+        Clock::time_point due = m_heap.front().due;
+        if (Clock::now() < due) {
+            m_cv.wait_until(lock, due);
+            continue;
+        }
+
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+        index = m_heap.back().index;
+        failures = m_heap.back().failures;
+        m_heap.pop_back();
+        m_running++;
+        return true;
+    }
+}
+
+// Marks a retry as done
+void RetryQueue::Finished(bool succeeded) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running--;
+        if (succeeded) {
+            m_recoveredHosts++;
+        }
+    }
+
+    // Waiting threads exit once nothing is queued or running
+    m_cv.notify_all();
+}
+
+// Returns the number of hosts deferred at least once
+size_t RetryQueue::GetDeferredHosts() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_deferredHosts;
+}
+
+// Returns the number of hosts that answered on a retry
+size_t RetryQueue::GetRecoveredHosts() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recoveredHosts;
+}
@@ -0,0 +1,95 @@
+#ifndef RETRYQUEUE_H
+#define RETRYQUEUE_H
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+
+/**
+ * @struct RetryOptions
+ * @brief Retry policy for transient probe failures
+ */
+struct RetryOptions {
+    int maxRetries = 2;             // Retries per host after the first attempt (0 = off)
+    double baseDelaySeconds = 5.0;  // Backoff before the first retry
+    double maxDelaySeconds = 60.0;  // Upper bound of the backoff
+};
+
+/**
+ * @class RetryQueue
+ * @brief Hosts whose probe failed transiently, ordered by the time they may be retried
+ *
+ * Scan threads defer a failed host instead of retrying it inline, so the
+ * main pass is never held up by backoff. Each retry waits twice as long as
+ * the previous one, with a random jitter of up to half the delay so hosts
+ * that failed together are not retried together. The backoff runs from the
+ * time of the failure, so on a long scan most hosts are due as soon as the
+ * main pass ends.
+ */
+class RetryQueue {
+public:
+    /**
+     * @brief Constructs the queue
+     * @param options Retry policy
+     */
+    explicit RetryQueue(const RetryOptions& options);
+
+    /**
+     * @brief Schedules a host for another attempt (thread-safe)
+     * @param index Index of the host
+     * @param failures Failed attempts so far, including this one
+     * @return False if the host has no retries left; the failure is final
+     */
+    bool Defer(size_t index, int failures);
+
+    /**
+     * @brief Waits until a deferred host is due and takes it (thread-safe)
+     * @param index Receives the index of the host
+     * @param failures Receives the failed attempts so far
+     * @return False once no host is queued and no retry is running
+     */
+    bool Next(size_t& index, int& failures);
+
+    /**
+     * @brief Marks a retry taken with Next() as done (thread-safe)
+     * @param succeeded True if the host answered this time
+     */
+    void Finished(bool succeeded);
+
+    /**
+     * @brief Returns the number of hosts deferred at least once
+     */
+    size_t GetDeferredHosts();
+
+    /**
+     * @brief Returns the number of hosts that answered on a retry
+     */
+    size_t GetRecoveredHosts();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief One deferred host
+     */
+    struct Entry {
+        Clock::time_point due;      // Earliest time of the next attempt
+        size_t index;               // Index of the host
+        int failures;               // Failed attempts so far
+
+        bool operator>(const Entry& other) const { return due > other.due; }
+    };
+
+    RetryOptions m_options;             // Retry policy
+    std::vector<Entry> m_heap;          // Deferred hosts, earliest due first
+    std::mutex m_mutex;                 // Protects all state
+    std::condition_variable m_cv;       // Signals new entries and finished retries
+    std::mt19937 m_rng;                 // Jitter source
+    size_t m_running;                   // Retries taken and not finished
+    size_t m_deferredHosts;             // Hosts deferred at least once
+    size_t m_recoveredHosts;            // Hosts that answered on a retry
+};
+
+#endif // RETRYQUEUE_H
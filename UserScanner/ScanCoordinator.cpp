@@ -0,0 +1,259 @@
+#include "ScanCoordinator.h"
+#include "HostCache.h"
+#include "UserLocator.h"
+#include "Hmac.h"
+#include <iostream>
+#include <future>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+    // Points per worker on the hash ring; evens out the partition sizes
+    const int kVirtualNodes = 128;
+}
+
+// Constructor
+ScanCoordinator::ScanCoordinator(const std::wstring& endpoint, int workerCount, bool partitionBySite,
+    const std::string& secret)
+    : m_endpoint(endpoint)
+    , m_workerCount(std::max(workerCount, 1))
+    , m_partitionBySite(partitionBySite)
+    , m_secret(secret)
+{
+}
+
+// Waits for all workers
+bool ScanCoordinator::AcceptWorkers(int joinTimeoutSeconds) {
+    using Clock = std::chrono::steady_clock;
+
+    if (!m_listener.Listen(m_endpoint)) {
+        return false;
+    }
+
+    std::wcout << L"[INFO] Waiting for " << m_workerCount << L" workers on " << m_endpoint << L"..." << std::endl;
+    auto deadline = Clock::now() + std::chrono::seconds(joinTimeoutSeconds);
+
+    while (static_cast<int>(m_workers.size()) < m_workerCount) {
+        auto remaining = std::chrono::duration_cast<std::chrono::seconds>(deadline - Clock::now()).count();
+        if (remaining <= 0) {
+            std::wcerr << L"[WARNING] Only " << m_workers.size() << L" of " << m_workerCount
+                << L" workers joined within " << joinTimeoutSeconds << L" s; continuing without the rest." << std::endl;
+            break;
+        }
+
+        auto worker = std::make_unique<WorkerState>();
+        worker->channel = std::make_unique<NetChannel>();
+        if (!m_listener.Accept(*worker->channel, static_cast<int>(remaining))) {
+            continue;
+        }
+
+        if (!Authenticate(*worker)) {
+            std::wcerr << L"[ERROR] Rejected connection from " << worker->channel->GetPeerName()
+                << L": handshake failed (wrong or missing token?)" << std::endl;
+            continue;
+        }
+
+        // Names are the ring keys and must be unique
+        std::wstring baseName = worker->name.empty() ? worker->channel->GetPeerName() : worker->name;
+        worker->name = baseName;
+        for (int suffix = 2; std::any_of(m_workers.begin(), m_workers.end(),
+            [&worker](const std::unique_ptr<WorkerState>& other) { return other->name == worker->name; }); ++suffix) {
+            worker->name = baseName + L"#" + std::to_wstring(suffix);
+        }
+
+        // From here on, a worker that stays silent past the timeout counts as disconnected
+        worker->channel->SetTimeouts(ScanProtocol::kPeerTimeoutSeconds, ScanProtocol::kPeerTimeoutSeconds);
+
+        std::wcout << L"[INFO] Worker " << worker->name << L" connected from "
+            << worker->channel->GetPeerName() << std::endl;
+        m_workers.push_back(std::move(worker));
+    }
+
+    m_listener.Close();
+    BuildRing();
+    return true;
+}
+
+// Runs the handshake: challenge, signed hello, signed welcome
+bool ScanCoordinator::Authenticate(WorkerState& worker) {
+    NetChannel& channel = *worker.channel;
+    channel.SetTimeouts(ScanProtocol::kHandshakeTimeoutSeconds, ScanProtocol::kHandshakeTimeoutSeconds);
+
+    std::string challenge = Hmac::MakeNonce();
+    if (!channel.SendFrame(static_cast<uint8_t>(MessageType::Challenge), challenge)) {
+        return false;
+    }
+
+    uint8_t type = 0;
+    std::string payload;
+    HelloMessage hello;
+    if (!channel.ReceiveFrame(type, payload) ||
+        type != static_cast<uint8_t>(MessageType::Hello) ||
+        !ScanProtocol::DecodeHello(payload, hello) ||
+        !Hmac::Equal(hello.proof, ScanProtocol::MakeWorkerProof(m_secret, challenge, hello.nonce, hello.workerName))) {
+        return false;
+    }
+
+    worker.name = hello.workerName;
+    if (!channel.SendFrame(static_cast<uint8_t>(MessageType::Welcome),
+        ScanProtocol::MakeCoordinatorProof(m_secret, challenge, hello.nonce))) {
+        return false;
+    }
+
+    // Every frame after the welcome carries a MAC, so results cannot be injected or changed in transit
+    channel.SetSessionKeys(ScanProtocol::MakeSessionKey(m_secret, challenge, hello.nonce, false),
+        ScanProtocol::MakeSessionKey(m_secret, challenge, hello.nonce, true));
+    return true;
+}
+
+// Partitions the hosts and sends the assignments
+bool ScanCoordinator::Distribute(const std::wstring& domain, const std::wstring& domainController,
+    const std::vector<ComputerInfo>& computers) {
+    if (m_workers.empty()) {
+        m_unassigned = computers;
+        return false;
+    }
+
+    for (const auto& computer : computers) {
+        m_workers[FindOwner(computer)]->computers.push_back(computer);
+    }
+
+    bool success = true;
+    for (auto& worker : m_workers) {
+        worker->received.assign(worker->computers.size(), 0);
+
+        ScanAssignment assignment;
+        assignment.domain = domain;
+        assignment.domainController = domainController;
+        assignment.computers = worker->computers;
+
+        if (!worker->channel->SendFrame(static_cast<uint8_t>(MessageType::Assign),
+            ScanProtocol::EncodeAssignment(assignment))) {
+            std::wcerr << L"[ERROR] Could not send the assignment to worker " << worker->name << std::endl;
+            worker->channel->Close();
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+// Receives results from all workers
+bool ScanCoordinator::CollectResults(const ResultHandler& onResult) {
+    std::vector<std::future<void>> futures;
+    for (auto& worker : m_workers) {
+        futures.push_back(std::async(std::launch::async,
+            &ScanCoordinator::ReceiveLoop, this, std::ref(*worker), std::cref(onResult)));
+    }
+
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    bool success = true;
+    for (const auto& worker : m_workers) {
+        if (!worker->done || worker->resultCount < worker->computers.size()) {
+            std::wcerr << L"[ERROR] Worker " << worker->name << L" stopped after "
+                << worker->resultCount << L" of " << worker->computers.size() << L" hosts." << std::endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+// Receive loop for one worker
+void ScanCoordinator::ReceiveLoop(WorkerState& worker, const ResultHandler& onResult) {
+    uint8_t type = 0;
+    std::string payload;
+    std::vector<ScanResult> results;
+
+    while (worker.channel->ReceiveFrame(type, payload)) {
+        if (type == static_cast<uint8_t>(MessageType::Done)) {
+            worker.done = true;
+            break;
+        }
+        if (type != static_cast<uint8_t>(MessageType::Results)) {
+            continue;
+        }
+
+        results.clear();
+        if (!ScanProtocol::DecodeResults(payload, results)) {
+            std::wcerr << L"[ERROR] Invalid results from worker " << worker.name << std::endl;
+            break;
+        }
+        worker.bytesReceived += payload.size();
+
+        for (const auto& result : results) {
+            // Ignore indexes outside the assignment and duplicates
+            if (result.index >= worker.computers.size() || worker.received[result.index]) {
+                continue;
+            }
+            worker.received[result.index] = 1;
+            worker.resultCount++;
+            onResult(worker.computers[result.index], result.errorCode, result.users);
+        }
+    }
+
+    worker.channel->Close();
+}
+
+// Returns the hosts without a result
+std::vector<ComputerInfo> ScanCoordinator::GetUnfinished() const {
+    std::vector<ComputerInfo> unfinished = m_unassigned;
+    for (const auto& worker : m_workers) {
+        for (size_t i = 0; i < worker->computers.size(); ++i) {
+            if (!worker->received[i]) {
+                unfinished.push_back(worker->computers[i]);
+            }
+        }
+    }
+    return unfinished;
+}
+
+// Prints hosts and results per worker
+void ScanCoordinator::PrintSummary() const {
+    std::wcout << L"Workers:" << std::endl;
+    for (const auto& worker : m_workers) {
+        std::wcout << L"  " << worker->name << L": " << worker->resultCount << L"/" << worker->computers.size()
+            << L" hosts, " << (worker->bytesReceived / 1024.0) << L" KB of results" << std::endl;
+    }
+}
+
+// Builds the hash ring
+void ScanCoordinator::BuildRing() {
+    m_ring.clear();
+    for (size_t w = 0; w < m_workers.size(); ++w) {
+        for (int v = 0; v < kVirtualNodes; ++v) {
+            m_ring.emplace_back(Hash(m_workers[w]->name + L"/" + std::to_wstring(v)), w);
+        }
+    }
+    std::sort(m_ring.begin(), m_ring.end());
+}
+
+// Returns the owner of a host: the first ring point at or after its hash
+size_t ScanCoordinator::FindOwner(const ComputerInfo& computer) const {
+    std::wstring key = HostCache::MakeKey(m_partitionBySite ?
+        UserLocator::GetNameGroup(computer.computerName) : computer.hostname);
+
+    auto it = std::lower_bound(m_ring.begin(), m_ring.end(), std::make_pair(Hash(key), static_cast<size_t>(0)));
+    if (it == m_ring.end()) {
+        it = m_ring.begin();
+    }
+    return it->second;
+}
+
+// 64-bit FNV-1a over the UTF-16/32 code units
+uint64_t ScanCoordinator::Hash(const std::wstring& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (wchar_t ch : text) {
+        hash ^= static_cast<uint64_t>(ch);
+        hash *= 1099511628211ull;
+    }
+
+    // FNV mixes the last characters poorly; finish with a 64-bit avalanche
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
@@ -0,0 +1,127 @@
+#ifndef SCANCOORDINATOR_H
+#define SCANCOORDINATOR_H
+
+#include "ADHelper.h"
+#include "NetChannel.h"
+#include "ScanProtocol.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class ScanCoordinator
+ * @brief Distributes the hosts of one scan to worker processes and collects their results
+ *
+ * Hosts are partitioned with a consistent-hash ring over the worker names,
+ * so a worker that rejoins under the same name gets mostly the same hosts
+ * as last time (and its local host cache stays useful), and adding a worker
+ * only moves the hosts it takes over. Results that never arrive, because a
+ * worker disconnected, went silent or never joined, are returned by
+ * GetUnfinished() for a local rescan.
+ */
+class ScanCoordinator {
+public:
+    /**
+     * @brief Called for each host result (from several threads at once)
+     */
+    using ResultHandler = std::function<void(const ComputerInfo&, long errorCode, const std::vector<UserInfo>&)>;
+
+    /**
+     * @brief Constructs the coordinator
+     * @param endpoint "[address:]port" to listen on
+     * @param workerCount Number of workers to wait for
+     * @param partitionBySite Keep each naming group (site prefix) on one worker
+     * @param secret Shared secret the workers must prove they know
+     */
+    ScanCoordinator(const std::wstring& endpoint, int workerCount, bool partitionBySite, const std::string& secret);
+
+    /**
+     * @brief Listens and waits until every worker has connected and authenticated
+     *
+     * Connections that fail the handshake are dropped. If the join timeout
+     * passes first, the scan goes ahead with the workers that joined; with
+     * none, every host is left for the local rescan.
+     *
+     * @param joinTimeoutSeconds How long to wait for all workers
+     * @return False if the endpoint could not be opened
+     */
+    bool AcceptWorkers(int joinTimeoutSeconds);
+
+    /**
+     * @brief Partitions the hosts and sends each worker its assignment
+     * @return True if every assignment was sent
+     */
+    bool Distribute(const std::wstring& domain, const std::wstring& domainController,
+        const std::vector<ComputerInfo>& computers);
+
+    /**
+     * @brief Receives results from all workers until each one is done or disconnected
+     * @param onResult Receives each host result
+     * @return True if every worker finished its assignment
+     */
+    bool CollectResults(const ResultHandler& onResult);
+
+    /**
+     * @brief Returns the hosts for which no result arrived
+     */
+    std::vector<ComputerInfo> GetUnfinished() const;
+
+    /**
+     * @brief Prints hosts and results per worker
+     */
+    void PrintSummary() const;
+
+private:
+    /**
+     * @brief State of one connected worker
+     */
+    struct WorkerState {
+        std::wstring name;                          // Worker name (unique)
+        std::unique_ptr<NetChannel> channel;        // Connection
+        std::vector<ComputerInfo> computers;        // Assigned hosts
+        std::vector<uint8_t> received;              // Result received, per host
+        std::atomic<size_t> resultCount{ 0 };       // Results received
+        std::atomic<uint64_t> bytesReceived{ 0 };   // Result payload bytes
+        bool done = false;                          // Done message received
+    };
+
+    std::wstring m_endpoint;                            // Listen endpoint
+    int m_workerCount;                                  // Workers to wait for
+    bool m_partitionBySite;                             // Partition by naming group
+    std::string m_secret;                               // Shared secret of the handshake
+    std::vector<ComputerInfo> m_unassigned;             // Hosts left over when no worker joined
+    NetChannel m_listener;                              // Listening socket
+    std::vector<std::unique_ptr<WorkerState>> m_workers; // Connected workers
+    std::vector<std::pair<uint64_t, size_t>> m_ring;    // Hash ring (point, worker index)
+
+    /**
+     * @brief Runs the handshake on a new connection and reads the worker name
+     * @return False if the peer did not prove it knows the secret
+     */
+    bool Authenticate(WorkerState& worker);
+
+    /**
+     * @brief Builds the hash ring from the worker names
+     */
+    void BuildRing();
+
+    /**
+     * @brief Returns the worker that owns a host
+     */
+    size_t FindOwner(const ComputerInfo& computer) const;
+
+    /**
+     * @brief Receive loop for one worker
+     */
+    void ReceiveLoop(WorkerState& worker, const ResultHandler& onResult);
+
+    /**
+     * @brief 64-bit FNV-1a hash of a string
+     */
+    static uint64_t Hash(const std::wstring& text);
+};
+
+#endif // SCANCOORDINATOR_H
@@ -0,0 +1,202 @@
+#include "ScanProtocol.h"
+#include "Platform.h"
+#include "Hmac.h"
+
+namespace {
+
+    /**
+     * @brief Sequential reader over a payload; every read fails once the data is exhausted
+     */
+    class PayloadReader {
+    public:
+        explicit PayloadReader(const std::string& data)
+            : m_data(data), m_pos(0) {
+        }
+
+        bool ReadVarint(uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (m_pos >= m_data.size()) {
+                    return false;
+                }
+                uint8_t byte = static_cast<uint8_t>(m_data[m_pos++]);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ReadString(std::wstring& value) {
+            uint64_t length = 0;
+            if (!ReadVarint(length) || length > m_data.size() - m_pos) {
+                return false;
+            }
+            value = UTF8ToWide(m_data.substr(m_pos, static_cast<size_t>(length)));
+            m_pos += static_cast<size_t>(length);
+            return true;
+        }
+
+        bool ReadBytes(std::string& value) {
+            uint64_t length = 0;
+            if (!ReadVarint(length) || length > m_data.size() - m_pos) {
+                return false;
+            }
+            value = m_data.substr(m_pos, static_cast<size_t>(length));
+            m_pos += static_cast<size_t>(length);
+            return true;
+        }
+
+        bool AtEnd() const { return m_pos == m_data.size(); }
+
+    private:
+        const std::string& m_data;
+        size_t m_pos;
+    };
+}
+
+// Encodes a worker introduction
+std::string ScanProtocol::EncodeHello(const HelloMessage& hello) {
+    std::string out;
+    AppendString(out, hello.workerName);
+    AppendBytes(out, hello.nonce);
+    AppendBytes(out, hello.proof);
+    return out;
+}
+
+// Decodes a worker introduction
+bool ScanProtocol::DecodeHello(const std::string& payload, HelloMessage& hello) {
+    PayloadReader reader(payload);
+    return reader.ReadString(hello.workerName) &&
+        reader.ReadBytes(hello.nonce) && hello.nonce.size() == Hmac::kDigestSize &&
+        reader.ReadBytes(hello.proof) && reader.AtEnd();
+}
+
+// Worker proof: nonces are fixed-size, so the concatenation is unambiguous
+std::string ScanProtocol::MakeWorkerProof(const std::string& secret, const std::string& challenge,
+    const std::string& workerNonce, const std::wstring& workerName) {
+    return Hmac::Sign(secret, std::string("UserScanner worker", 19) + challenge + workerNonce + WideToUTF8(workerName));
+}
+
+// Coordinator proof: a different label and order, so a worker proof cannot be replayed as one
+std::string ScanProtocol::MakeCoordinatorProof(const std::string& secret, const std::string& challenge,
+    const std::string& workerNonce) {
+    return Hmac::Sign(secret, std::string("UserScanner coordinator", 24) + workerNonce + challenge);
+}
+
+// Session key: fresh nonces make it unique per connection, the label per direction
+std::string ScanProtocol::MakeSessionKey(const std::string& secret, const std::string& challenge,
+    const std::string& workerNonce, bool fromWorker) {
+    std::string label = fromWorker ? "UserScanner session worker" : "UserScanner session coordinator";
+    return Hmac::Sign(secret, label + '\0' + challenge + workerNonce);
+}
+
+// Encodes an assignment
+std::string ScanProtocol::EncodeAssignment(const ScanAssignment& assignment) {
+    std::string out;
+    AppendString(out, assignment.domain);
+    AppendString(out, assignment.domainController);
+    AppendVarint(out, assignment.computers.size());
+
+    for (const auto& computer : assignment.computers) {
+        AppendString(out, computer.hostname);
+        AppendString(out, computer.computerName);
+        AppendString(out, computer.operatingSystem);
+    }
+    return out;
+}
+
+// Decodes an assignment
+bool ScanProtocol::DecodeAssignment(const std::string& payload, ScanAssignment& assignment) {
+    PayloadReader reader(payload);
+    uint64_t count = 0;
+
+    if (!reader.ReadString(assignment.domain) ||
+        !reader.ReadString(assignment.domainController) ||
+        !reader.ReadVarint(count) || count > payload.size()) {
+        return false;
+    }
+
+    assignment.computers.clear();
+    assignment.computers.reserve(static_cast<size_t>(count));
+
+    for (uint64_t i = 0; i < count; ++i) {
+        ComputerInfo computer;
+        if (!reader.ReadString(computer.hostname) ||
+            !reader.ReadString(computer.computerName) ||
+            !reader.ReadString(computer.operatingSystem)) {
+            return false;
+        }
+        assignment.computers.push_back(std::move(computer));
+    }
+    return reader.AtEnd();
+}
+
+// Appends one host result
+void ScanProtocol::AppendResult(std::string& out, uint32_t index, long errorCode, const std::vector<UserInfo>& users) {
+    // Zigzag keeps small negative codes short
+    int64_t code = errorCode;
+    AppendVarint(out, index);
+    AppendVarint(out, (static_cast<uint64_t>(code) << 1) ^ static_cast<uint64_t>(code >> 63));
+    AppendVarint(out, users.size());
+
+    for (const auto& user : users) {
+        AppendString(out, user.sid);
+        AppendString(out, user.domainName);
+        AppendString(out, user.userName);
+    }
+}
+
+// Decodes a results payload
+bool ScanProtocol::DecodeResults(const std::string& payload, std::vector<ScanResult>& results) {
+    PayloadReader reader(payload);
+
+    while (!reader.AtEnd()) {
+        ScanResult result;
+        uint64_t index = 0;
+        uint64_t code = 0;
+        uint64_t userCount = 0;
+
+        if (!reader.ReadVarint(index) || !reader.ReadVarint(code) || !reader.ReadVarint(userCount) ||
+            index > UINT32_MAX || userCount > payload.size()) {
+            return false;
+        }
+
+        result.index = static_cast<uint32_t>(index);
+        result.errorCode = static_cast<long>(static_cast<int64_t>(code >> 1) ^ -static_cast<int64_t>(code & 1));
+
+        for (uint64_t i = 0; i < userCount; ++i) {
+            UserInfo user;
+            if (!reader.ReadString(user.sid) || !reader.ReadString(user.domainName) ||
+                !reader.ReadString(user.userName)) {
+                return false;
+            }
+            result.users.push_back(std::move(user));
+        }
+        results.push_back(std::move(result));
+    }
+    return true;
+}
+
+// Appends an unsigned LEB128 varint
+void ScanProtocol::AppendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Appends a length-prefixed UTF-8 string
+void ScanProtocol::AppendString(std::string& out, const std::wstring& value) {
+    std::string utf8 = WideToUTF8(value);
+    AppendVarint(out, utf8.size());
+    out += utf8;
+}
+
+// Appends length-prefixed raw bytes
+void ScanProtocol::AppendBytes(std::string& out, const std::string& value) {
+    AppendVarint(out, value.size());
+    out += value;
+}
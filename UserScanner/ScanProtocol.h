@@ -0,0 +1,152 @@
+#ifndef SCANPROTOCOL_H
+#define SCANPROTOCOL_H
+
+#include "ADHelper.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @enum MessageType
+ * @brief Frame types exchanged between the coordinator and its workers
+ */
+enum class MessageType : uint8_t {
+    Hello = 1,          // Worker -> coordinator: worker name, nonce and proof of the secret
+    Assign = 2,         // Coordinator -> worker: domain and the worker's hosts
+    Results = 3,        // Worker -> coordinator: a batch of host results
+    Done = 4,           // Worker -> coordinator: all hosts scanned
+    Challenge = 5,      // Coordinator -> worker: nonce the worker must sign
+    Welcome = 6,        // Coordinator -> worker: proof of the secret over the worker's nonce
+    Heartbeat = 7       // Worker -> coordinator: still scanning, no results to send
+};
+
+/**
+ * @struct HelloMessage
+ * @brief Worker introduction, authenticated with the shared secret
+ */
+struct HelloMessage {
+    std::wstring workerName;                // Partitioning key of the worker
+    std::string nonce;                      // Worker nonce, signed back by the coordinator
+    std::string proof;                      // HMAC over the coordinator nonce, worker nonce and name
+};
+
+/**
+ * @struct ScanAssignment
+ * @brief Hosts assigned to one worker
+ */
+struct ScanAssignment {
+    std::wstring domain;                    // Domain name
+    std::wstring domainController;          // Domain controller
+    std::vector<ComputerInfo> computers;    // Hosts to scan
+};
+
+/**
+ * @struct ScanResult
+ * @brief Result of one host, as reported by a worker
+ */
+struct ScanResult {
+    uint32_t index = 0;                     // Position in the worker's assignment
+    long errorCode = 0;                     // Registry connection result
+    std::vector<UserInfo> users;            // Logged-on users
+};
+
+/**
+ * @class ScanProtocol
+ * @brief Compact binary encoding of assignments and results
+ *
+ * Integers are LEB128 varints (error codes zigzag-encoded) and strings are
+ * a varint byte length followed by UTF-8. Results refer to hosts by their
+ * index in the assignment, so a result without users costs a few bytes.
+ *
+ * Before any host is handed out, both sides prove that they know the shared
+ * secret: each signs the other's random nonce with HMAC-SHA256, so neither
+ * the secret nor a reusable proof crosses the network. Every later frame is
+ * authenticated with session keys derived from both nonces. Frames are not
+ * encrypted: host names and user names can be read on the network path.
+ */
+class ScanProtocol {
+public:
+    /**
+     * @brief Interval at which an idle worker sends a heartbeat
+     */
+    static const int kHeartbeatSeconds = 5;
+
+    /**
+     * @brief Silence after which the coordinator treats a worker as disconnected
+     */
+    static const int kPeerTimeoutSeconds = 60;
+
+    /**
+     * @brief Time allowed for each side of the handshake
+     */
+    static const int kHandshakeTimeoutSeconds = 10;
+
+    /**
+     * @brief Encodes a worker introduction
+     */
+    static std::string EncodeHello(const HelloMessage& hello);
+
+    /**
+     * @brief Decodes a worker introduction
+     * @return False if the payload is malformed
+     */
+    static bool DecodeHello(const std::string& payload, HelloMessage& hello);
+
+    /**
+     * @brief Returns the worker's proof of the secret
+     * @param secret Shared secret
+     * @param challenge Nonce sent by the coordinator
+     * @param workerNonce Nonce chosen by the worker
+     * @param workerName Name the worker introduces itself with
+     */
+    static std::string MakeWorkerProof(const std::string& secret, const std::string& challenge,
+        const std::string& workerNonce, const std::wstring& workerName);
+
+    /**
+     * @brief Returns the coordinator's proof of the secret
+     * @param secret Shared secret
+     * @param challenge Nonce sent by the coordinator
+     * @param workerNonce Nonce chosen by the worker
+     */
+    static std::string MakeCoordinatorProof(const std::string& secret, const std::string& challenge,
+        const std::string& workerNonce);
+
+    /**
+     * @brief Returns the key that authenticates the frames of one direction after the handshake
+     * @param secret Shared secret
+     * @param challenge Nonce sent by the coordinator
+     * @param workerNonce Nonce chosen by the worker
+     * @param fromWorker True for worker -> coordinator frames, false for the other direction
+     */
+    static std::string MakeSessionKey(const std::string& secret, const std::string& challenge,
+        const std::string& workerNonce, bool fromWorker);
+
+    /**
+     * @brief Encodes an assignment
+     */
+    static std::string EncodeAssignment(const ScanAssignment& assignment);
+
+    /**
+     * @brief Decodes an assignment
+     * @return False if the payload is malformed
+     */
+    static bool DecodeAssignment(const std::string& payload, ScanAssignment& assignment);
+
+    /**
+     * @brief Appends one host result to a results payload
+     */
+    static void AppendResult(std::string& out, uint32_t index, long errorCode, const std::vector<UserInfo>& users);
+
+    /**
+     * @brief Decodes a results payload
+     * @return False if the payload is malformed
+     */
+    static bool DecodeResults(const std::string& payload, std::vector<ScanResult>& results);
+
+private:
+    static void AppendVarint(std::string& out, uint64_t value);
+    static void AppendString(std::string& out, const std::wstring& value);
+    static void AppendBytes(std::string& out, const std::string& value);
+};
+
+#endif // SCANPROTOCOL_H
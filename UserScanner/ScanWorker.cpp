@@ -0,0 +1,198 @@
+#include "ScanWorker.h"
+#include "Platform.h"
+#include "Hmac.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include <iostream>
+#include <chrono>
+
+namespace {
+
+    // Results are sent once this much is batched
+    const size_t kBatchSize = 64 * 1024;
+
+    // How long a worker waits for the coordinator to come up
+    const int kConnectTimeoutSeconds = 300;
+}
+
+// Constructor
+ScanWorker::ScanWorker(const std::wstring& coordinator, const std::wstring& name, const std::string& secret)
+    : m_coordinator(coordinator)
+    , m_name(name.empty() ? GetDefaultName() : name)
+    , m_secret(secret)
+    , m_failed(false)
+    , m_stopping(false)
+{
+}
+
+// Destructor
+ScanWorker::~ScanWorker() {
+    StopHeartbeat();
+}
+
+// Connects and receives the assignment
+bool ScanWorker::Connect(ScanAssignment& assignment) {
+    std::wcout << L"[INFO] Worker " << m_name << L" connecting to " << m_coordinator << L"..." << std::endl;
+
+    if (!m_channel.Connect(m_coordinator, kConnectTimeoutSeconds)) {
+        return false;
+    }
+
+    if (!Authenticate()) {
+        std::wcerr << L"[ERROR] Handshake with the coordinator failed (wrong or missing token?)" << std::endl;
+        return false;
+    }
+
+    // The coordinator answers once every worker has joined; sends must not hang on a stuck coordinator
+    m_channel.SetTimeouts(0, ScanProtocol::kPeerTimeoutSeconds);
+    uint8_t type = 0;
+    std::string payload;
+    if (!m_channel.ReceiveFrame(type, payload) ||
+        type != static_cast<uint8_t>(MessageType::Assign) ||
+        !ScanProtocol::DecodeAssignment(payload, assignment)) {
+        std::wcerr << L"[ERROR] No valid assignment received from the coordinator." << std::endl;
+        return false;
+    }
+
+    std::wcout << L"[INFO] Assigned " << assignment.computers.size() << L" hosts ("
+        << (payload.size() / 1024.0) << L" KB)" << std::endl;
+
+    m_heartbeat = std::thread(&ScanWorker::HeartbeatLoop, this);
+    return true;
+}
+
+// Answers the coordinator's challenge and checks its proof
+bool ScanWorker::Authenticate() {
+    m_channel.SetTimeouts(ScanProtocol::kHandshakeTimeoutSeconds, ScanProtocol::kHandshakeTimeoutSeconds);
+
+    uint8_t type = 0;
+    std::string challenge;
+    if (!m_channel.ReceiveFrame(type, challenge) ||
+        type != static_cast<uint8_t>(MessageType::Challenge) ||
+        challenge.size() != Hmac::kDigestSize) {
+        return false;
+    }
+
+    HelloMessage hello;
+    hello.workerName = m_name;
+    hello.nonce = Hmac::MakeNonce();
+    hello.proof = ScanProtocol::MakeWorkerProof(m_secret, challenge, hello.nonce, m_name);
+    if (!m_channel.SendFrame(static_cast<uint8_t>(MessageType::Hello), ScanProtocol::EncodeHello(hello))) {
+        return false;
+    }
+
+    // Only a coordinator that knows the secret may hand out hosts to scan with this worker's credentials
+    std::string proof;
+    if (!m_channel.ReceiveFrame(type, proof) ||
+        type != static_cast<uint8_t>(MessageType::Welcome) ||
+        !Hmac::Equal(proof, ScanProtocol::MakeCoordinatorProof(m_secret, challenge, hello.nonce))) {
+        return false;
+    }
+
+    // Same keys as the coordinator, with the directions swapped
+    m_channel.SetSessionKeys(ScanProtocol::MakeSessionKey(m_secret, challenge, hello.nonce, true),
+        ScanProtocol::MakeSessionKey(m_secret, challenge, hello.nonce, false));
+    return true;
+}
+
+// Queues the result of one host
+void ScanWorker::AddResult(size_t index, long errorCode, const std::vector<UserInfo>& users) {
+    std::string full;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ScanProtocol::AppendResult(m_batch, static_cast<uint32_t>(index), errorCode, users);
+        if (m_batch.size() < kBatchSize) {
+            return;
+        }
+        full.swap(m_batch);
+    }
+
+    // The send happens outside the lock so other scan threads keep encoding
+    SendBatch(full);
+}
+
+// Sends the remaining results and the done message
+bool ScanWorker::Finish() {
+    StopHeartbeat();
+
+    std::string rest;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        rest.swap(m_batch);
+    }
+
+    if (!rest.empty()) {
+        SendBatch(rest);
+    }
+
+    if (m_failed || !m_channel.SendFrame(static_cast<uint8_t>(MessageType::Done), std::string())) {
+        std::wcerr << L"[ERROR] Connection to the coordinator was lost; results are incomplete." << std::endl;
+        m_channel.Close();
+        return false;
+    }
+
+    m_channel.Close();
+    return true;
+}
+
+// Sends one results frame
+void ScanWorker::SendBatch(const std::string& batch) {
+    if (!m_channel.SendFrame(static_cast<uint8_t>(MessageType::Results), batch)) {
+        m_failed = true;
+    }
+}
+
+// Sends the pending results, or a heartbeat, every few seconds
+void ScanWorker::HeartbeatLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopSignal.wait_for(lock, std::chrono::seconds(ScanProtocol::kHeartbeatSeconds),
+        [this] { return m_stopping; })) {
+        std::string pending;
+        pending.swap(m_batch);
+        lock.unlock();
+
+        if (!pending.empty()) {
+            SendBatch(pending);
+        }
+        else if (!m_channel.SendFrame(static_cast<uint8_t>(MessageType::Heartbeat), std::string())) {
+            m_failed = true;
+        }
+
+        lock.lock();
+    }
+}
+
+// Stops the heartbeat thread
+void ScanWorker::StopHeartbeat() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_stopSignal.notify_all();
+
+    if (m_heartbeat.joinable()) {
+        m_heartbeat.join();
+    }
+}
+
+// Returns the computer name
+std::wstring ScanWorker::GetDefaultName() {
+#ifdef _WIN32
+    wchar_t name[256] = { 0 };
+    DWORD size = sizeof(name) / sizeof(wchar_t);
+    if (GetComputerNameW(name, &size)) {
+        return std::wstring(name, size);
+    }
+    return L"worker";
+#else
+    char name[256] = { 0 };
+    if (gethostname(name, sizeof(name) - 1) == 0) {
+        return UTF8ToWide(name);
+    }
+    return L"worker";
+#endif
+}
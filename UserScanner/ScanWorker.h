@@ -0,0 +1,103 @@
+#ifndef SCANWORKER_H
+#define SCANWORKER_H
+
+#include "ADHelper.h"
+#include "NetChannel.h"
+#include "ScanProtocol.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class ScanWorker
+ * @brief Worker side of a distributed scan: receives hosts, streams results back
+ *
+ * Scan threads call AddResult(), which appends the encoded result to a
+ * shared batch; full batches are sent as one frame outside the lock. A
+ * background thread sends partial batches, or a heartbeat when there is
+ * nothing to send, every few seconds, so the coordinator can tell a slow
+ * scan from a dead worker.
+ */
+class ScanWorker {
+public:
+    /**
+     * @brief Constructs the worker
+     * @param coordinator "address:port" of the coordinator
+     * @param name Worker name, the partitioning key (empty = computer name)
+     * @param secret Shared secret of the handshake
+     */
+    ScanWorker(const std::wstring& coordinator, const std::wstring& name, const std::string& secret);
+
+    /**
+     * @brief Stops the heartbeat thread
+     */
+    ~ScanWorker();
+
+    ScanWorker(const ScanWorker&) = delete;
+    ScanWorker& operator=(const ScanWorker&) = delete;
+
+    /**
+     * @brief Connects, authenticates both ways and waits for the assignment
+     * @param assignment Receives the hosts to scan
+     * @return True if successful
+     */
+    bool Connect(ScanAssignment& assignment);
+
+    /**
+     * @brief Queues the result of one host (thread-safe)
+     * @param index Position of the host in the assignment
+     * @param errorCode Registry connection result
+     * @param users Logged-on users
+     */
+    void AddResult(size_t index, long errorCode, const std::vector<UserInfo>& users);
+
+    /**
+     * @brief Sends the remaining results and the done message
+     * @return True if every result was delivered to the connection
+     */
+    bool Finish();
+
+    /**
+     * @brief Returns the default worker name (the computer name)
+     */
+    static std::wstring GetDefaultName();
+
+private:
+    std::wstring m_coordinator;     // Coordinator endpoint
+    std::wstring m_name;            // Worker name
+    std::string m_secret;           // Shared secret of the handshake
+    NetChannel m_channel;           // Connection to the coordinator
+    std::mutex m_mutex;             // Protects m_batch and m_stopping
+    std::string m_batch;            // Encoded results not sent yet
+    std::atomic<bool> m_failed;     // A send failed
+    std::condition_variable m_stopSignal;   // Wakes the heartbeat thread to stop
+    bool m_stopping;                // Heartbeat thread should exit
+    std::thread m_heartbeat;        // Periodic flush / heartbeat thread
+
+    /**
+     * @brief Runs the handshake and checks the coordinator's proof
+     * @return False if the coordinator did not prove it knows the secret
+     */
+    bool Authenticate();
+
+    /**
+     * @brief Sends a batch as one results frame
+     */
+    void SendBatch(const std::string& batch);
+
+    /**
+     * @brief Sends the pending results, or a heartbeat, every few seconds until stopped
+     */
+    void HeartbeatLoop();
+
+    /**
+     * @brief Stops the heartbeat thread and waits for it
+     */
+    void StopHeartbeat();
+};
+
+#endif // SCANWORKER_H
@@ -0,0 +1,206 @@
+#include "Tracer.h"
+#include "Platform.h"
+#include <iostream>
+#include <cstdio>
+
+namespace {
+
+    // Trace output is handed to the file in blocks of this size
+    const size_t kWriteBlockSize = 1024 * 1024;
+
+    // Buffer of the calling thread and the tracer it belongs to
+    thread_local void* t_bufferOwner = nullptr;
+    thread_local void* t_buffer = nullptr;
+
+    // Microseconds since the trace origin, with sub-microsecond precision
+    void AppendMicroseconds(std::string& out, Tracer::Clock::duration duration) {
+        char text[32];
+        snprintf(text, sizeof(text), "%.3f", std::chrono::duration<double, std::micro>(duration).count());
+        out += text;
+    }
+}
+
+std::atomic<Tracer*> Tracer::s_active(nullptr);
+
+// Constructor
+Tracer::Tracer(const std::wstring& outputPath, size_t spansPerThread)
+    : m_outputPath(outputPath)
+    , m_spansPerThread(spansPerThread > 0 ? spansPerThread : 1)
+    , m_running(false)
+{
+}
+
+// Destructor
+Tracer::~Tracer() {
+    Stop();
+}
+
+// Opens the trace file and starts recording
+bool Tracer::Start() {
+    m_output.open(ToNativePath(m_outputPath), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!m_output.is_open()) {
+        std::wcerr << L"[ERROR] Could not open trace file: " << m_outputPath << std::endl;
+        return false;
+    }
+
+    Tracer* expected = nullptr;
+    m_startTime = Clock::now();
+    if (!s_active.compare_exchange_strong(expected, this)) {
+        std::wcerr << L"[ERROR] Another trace is already running." << std::endl;
+        m_output.close();
+        return false;
+    }
+
+    m_running = true;
+    std::wcout << L"[INFO] Tracing to " << m_outputPath << std::endl;
+    return true;
+}
+
+// Stops recording and writes the trace file
+bool Tracer::Stop() {
+    if (!m_running) {
+        return false;
+    }
+    m_running = false;
+
+    Tracer* self = this;
+    s_active.compare_exchange_strong(self, nullptr);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string out;
+    out.reserve(kWriteBlockSize + 4096);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    uint64_t spanCount = 0;
+    uint64_t overwritten = 0;
+    bool first = true;
+
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+        // Thread name shown in the viewer
+        out += first ? "" : ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        out += std::to_string(buffer->threadId);
+        out += ",\"args\":{\"name\":\"thread ";
+        out += std::to_string(buffer->threadId);
+        out += "\"}}";
+
+        // Oldest span first: after a wrap-around the ring starts at next
+        size_t count = buffer->spans.size();
+        for (size_t n = 0; n < count; ++n) {
+            const Span& span = buffer->spans[(buffer->next + n) % count];
+
+            out += ",\n{\"name\":\"";
+            out += span.name;
+            out += "\",\"cat\":\"";
+            out += span.category;
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            out += std::to_string(buffer->threadId);
+            out += ",\"ts\":";
+            AppendMicroseconds(out, span.start - m_startTime);
+            out += ",\"dur\":";
+            AppendMicroseconds(out, span.end - span.start);
+            if (!span.detail.empty()) {
+                out += ",\"args\":{\"detail\":";
+                AppendJsonString(out, WideToUTF8(span.detail));
+                out += "}";
+            }
+            out += "}";
+
+            if (out.size() >= kWriteBlockSize) {
+                m_output.write(out.data(), static_cast<std::streamsize>(out.size()));
+                out.clear();
+            }
+        }
+
+        spanCount += count;
+        overwritten += buffer->overwritten;
+    }
+
+    out += "\n],\"otherData\":{\"overwrittenSpans\":";
+    out += std::to_string(overwritten);
+    out += "}}\n";
+    m_output.write(out.data(), static_cast<std::streamsize>(out.size()));
+    m_output.close();
+
+    if (!m_output) {
+        std::wcerr << L"[ERROR] Could not write trace file: " << m_outputPath << std::endl;
+        return false;
+    }
+
+    std::wcout << L"[INFO] Trace: " << spanCount << L" spans from " << m_buffers.size()
+        << L" threads written to " << m_outputPath;
+    if (overwritten > 0) {
+        std::wcout << L" (" << overwritten << L" oldest spans overwritten; raise --trace-buffer)";
+    }
+    std::wcout << std::endl;
+    return true;
+}
+
+// Records one finished span
+void Tracer::Record(const char* name, const char* category, Clock::time_point start, Clock::time_point end,
+    const std::wstring& detail) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    // Grow until the capacity is reached, then overwrite the oldest span
+    Span* span = nullptr;
+    if (buffer.spans.size() < m_spansPerThread) {
+        buffer.spans.emplace_back();
+        span = &buffer.spans.back();
+    }
+    else {
+        span = &buffer.spans[buffer.next];
+        buffer.next = (buffer.next + 1) % buffer.spans.size();
+        buffer.overwritten++;
+    }
+
+    span->name = name;
+    span->category = category;
+    span->start = start;
+    span->end = end;
+    span->detail = detail;
+}
+
+// Returns the buffer of the calling thread
+Tracer::ThreadBuffer& Tracer::GetThreadBuffer() {
+    if (t_bufferOwner == this) {
+        return *static_cast<ThreadBuffer*>(t_buffer);
+    }
+
+    // The tracer keeps the buffer, so spans survive the thread
+    auto buffer = std::make_shared<ThreadBuffer>();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer->threadId = static_cast<int>(m_buffers.size()) + 1;
+        m_buffers.push_back(buffer);
+    }
+
+    t_bufferOwner = this;
+    t_buffer = buffer.get();
+    return *buffer;
+}
+
+// Appends a string as a JSON string literal
+void Tracer::AppendJsonString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char ch : text) {
+        unsigned char byte = static_cast<unsigned char>(ch);
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        }
+        else if (byte < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", byte);
+            out += escaped;
+        }
+        else {
+            out += ch;
+        }
+    }
+    out += '"';
+}
@@ -0,0 +1,167 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class Tracer
+ * @brief Records timed spans per thread and writes them as a Chrome trace
+ *
+ * While a tracer is started it is the process-wide target of TraceSpan.
+ * Each thread appends to its own ring buffer, so recording costs two clock
+ * reads and an uncontended lock; when a buffer is full the oldest spans
+ * are overwritten. Stop() writes every buffer as Chrome trace event JSON,
+ * which chrome://tracing and Perfetto open as a per-thread timeline.
+ */
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs the tracer
+     * @param outputPath Trace file to write
+     * @param spansPerThread Ring buffer capacity of each thread
+     */
+    Tracer(const std::wstring& outputPath, size_t spansPerThread);
+
+    /**
+     * @brief Stops the tracer and writes the trace if still running
+     */
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Opens the trace file and starts recording
+     * @return True if successful (false if another tracer is running or the file could not be opened)
+     */
+    bool Start();
+
+    /**
+     * @brief Stops recording and writes the trace file
+     *
+     * Call once the traced threads are done; spans still open keep a
+     * pointer to the tracer.
+     *
+     * @return True if the file was written
+     */
+    bool Stop();
+
+    /**
+     * @brief Records one finished span on the calling thread's buffer (thread-safe)
+     * @param name Span name (static string)
+     * @param category Span category (static string)
+     * @param start Start of the span
+     * @param end End of the span
+     * @param detail Host name, filter or other detail (may be empty)
+     */
+    void Record(const char* name, const char* category, Clock::time_point start, Clock::time_point end,
+        const std::wstring& detail);
+
+    /**
+     * @brief Returns the running tracer, or nullptr if tracing is off
+     */
+    static Tracer* GetActive() { return s_active.load(std::memory_order_acquire); }
+
+private:
+    /**
+     * @brief One recorded span
+     */
+    struct Span {
+        const char* name;               // Span name
+        const char* category;           // Span category
+        Clock::time_point start;        // Start time
+        Clock::time_point end;          // End time
+        std::wstring detail;            // Detail argument (reused between spans)
+    };
+
+    /**
+     * @brief Ring buffer of one thread
+     */
+    struct ThreadBuffer {
+        std::mutex mutex;               // Taken by the owner thread and by Stop()
+        std::vector<Span> spans;        // Ring storage, grown up to the capacity
+        size_t next = 0;                // Slot for the next span once the ring is full
+        uint64_t overwritten = 0;       // Spans lost to wrap-around
+        int threadId = 0;               // Trace thread id
+    };
+
+    std::wstring m_outputPath;          // Trace file
+    std::ofstream m_output;             // Trace file stream (opened by Start)
+    size_t m_spansPerThread;            // Ring capacity per thread
+    Clock::time_point m_startTime;      // Time origin of the trace
+    std::mutex m_mutex;                 // Protects m_buffers
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;   // One per recording thread
+    bool m_running;                     // Started and not stopped
+
+    static std::atomic<Tracer*> s_active;   // Tracer receiving spans
+
+    /**
+     * @brief Returns the buffer of the calling thread, registering it on first use
+     */
+    ThreadBuffer& GetThreadBuffer();
+
+    /**
+     * @brief Appends a string as a JSON string literal
+     */
+    static void AppendJsonString(std::string& out, const std::string& text);
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the lifetime of a scope as a span when tracing is on
+ *
+ * With tracing off the cost is one atomic load.
+ */
+class TraceSpan {
+public:
+    /**
+     * @brief Starts the span
+     * @param name Span name (static string)
+     * @param category Span category (static string)
+     * @param detail Host name, filter or other detail (copied only when tracing)
+     */
+    TraceSpan(const char* name, const char* category, const wchar_t* detail = nullptr)
+        : m_tracer(Tracer::GetActive())
+        , m_name(name)
+        , m_category(category)
+    {
+        if (m_tracer) {
+            if (detail) {
+                m_detail = detail;
+            }
+            m_start = Tracer::Clock::now();
+        }
+    }
+
+    TraceSpan(const char* name, const char* category, const std::wstring& detail)
+        : TraceSpan(name, category, detail.c_str())
+    {
+    }
+
+    ~TraceSpan() {
+        if (m_tracer) {
+            m_tracer->Record(m_name, m_category, m_start, Tracer::Clock::now(), m_detail);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    Tracer* m_tracer;                   // Tracer at span start (nullptr = off)
+    const char* m_name;                 // Span name
+    const char* m_category;             // Span category
+    std::wstring m_detail;              // Detail argument
+    Tracer::Clock::time_point m_start;  // Start time
+};
+
+#endif // TRACER_H
@@ -0,0 +1,209 @@
+#include "UserLocator.h"
+#include "HostCache.h"
+#include "ProgressReporter.h"
+#include "DnsResolver.h"
+#include <iostream>
+#include <future>
+#include <algorithm>
+#include <cwctype>
+
+// Constructor
+UserLocator::UserLocator(const std::vector<UserInfo>& targets, const LocateBudget& budget)
+    : m_targets(targets)
+    , m_budget(budget)
+    , m_startTime(Clock::now())
+    , m_locations(targets.size())
+    , m_remaining(targets.size())
+    , m_hostsProbed(0)
+    , m_nextIndex(0)
+{
+    for (const auto& target : m_targets) {
+        m_targetKeys.push_back(HostCache::MakeKey(target.sid));
+    }
+}
+
+// Returns the hosts on which a target was seen before
+std::vector<ComputerInfo> UserLocator::GetHistoryCandidates(HostCache& history, const std::wstring& domain) {
+    std::vector<ComputerInfo> candidates;
+
+    for (const auto& host : history.FindHostsWithSubKey(m_targetKeys)) {
+        // The operating system is looked up later, only for hosts that match
+        candidates.emplace_back(host, ADHelper::ExtractComputerName(host, domain), L"");
+    }
+
+    return candidates;
+}
+
+// Sorts the hosts by likelihood of holding a target session
+void UserLocator::OrderByLikelihood(std::vector<ComputerInfo>& computers, HostCache* history) {
+    std::unordered_set<std::wstring> seenHosts;
+    std::unordered_set<std::wstring> seenGroups;
+
+    if (history) {
+        for (const auto& host : history->FindHostsWithSubKey(m_targetKeys)) {
+            seenHosts.insert(host);
+            seenGroups.insert(GetNameGroup(host.substr(0, host.find(L'.'))));
+        }
+    }
+
+    std::vector<std::pair<int, ComputerInfo>> ranked;
+    ranked.reserve(computers.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& computer : computers) {
+            std::wstring key = HostCache::MakeKey(computer.hostname);
+            if (m_probed.count(key)) {
+                continue;
+            }
+
+            int rank = 3;
+            if (seenHosts.count(key)) {
+                rank = 0;
+            }
+            else if (!seenGroups.empty() && seenGroups.count(GetNameGroup(HostCache::MakeKey(computer.computerName)))) {
+                rank = 1;
+            }
+            else if (history && history->Contains(key)) {
+                rank = 2;
+            }
+
+            ranked.emplace_back(rank, std::move(computer));
+        }
+    }
+
+    std::stable_sort(ranked.begin(), ranked.end(),
+        [](const std::pair<int, ComputerInfo>& a, const std::pair<int, ComputerInfo>& b) {
+            return a.first < b.first;
+        });
+
+    computers.clear();
+    for (auto& item : ranked) {
+        computers.push_back(std::move(item.second));
+    }
+}
+
+// Probes the hosts in order
+bool UserLocator::Probe(const SidProbe& probe, const std::vector<ComputerInfo>& computers, int threadCount,
+    const MatchHandler& onMatch, const std::wstring& progressFile) {
+    if (computers.empty() || ShouldStop()) {
+        return true;
+    }
+
+    ProgressReporter progress(computers.size(), progressFile);
+    if (!progress.Start()) {
+        return false;
+    }
+
+    // Workers share one index so the most likely hosts are probed first
+    m_nextIndex = 0;
+    size_t workers = std::min<size_t>(static_cast<size_t>(std::max(threadCount, 1)), computers.size());
+
+    std::vector<std::future<void>> futures;
+    for (size_t t = 0; t < workers; ++t) {
+        futures.push_back(std::async(std::launch::async,
+            &UserLocator::ProbeLoop, this,
+            std::cref(probe),
+            std::cref(computers),
+            std::cref(onMatch),
+            std::ref(progress)));
+    }
+
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    progress.Stop();
+    return true;
+}
+
+// Worker thread body
+void UserLocator::ProbeLoop(const SidProbe& probe, const std::vector<ComputerInfo>& computers,
+    const MatchHandler& onMatch, ProgressReporter& progress) {
+    while (!ShouldStop()) {
+        size_t index = m_nextIndex.fetch_add(1);
+        if (index >= computers.size()) {
+            break;
+        }
+
+        // Claim one host from the budget; threads racing past the limit give it back
+        size_t claimed = m_hostsProbed.fetch_add(1);
+        if (m_budget.maxHosts > 0 && claimed >= m_budget.maxHosts) {
+            m_hostsProbed--;
+            break;
+        }
+
+        const auto& computer = computers[index];
+
+        // Names that do not resolve are not probed
+        long errorCode = DnsResolver::kHostNotFound;
+        std::vector<std::wstring> sids;
+        if (!computer.nameNotFound) {
+            errorCode = 0;
+            sids = probe(computer, errorCode);
+        }
+        progress.RecordHost(ProgressReporter::Classify(errorCode));
+
+        std::vector<UserInfo> matches;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_probed.insert(HostCache::MakeKey(computer.hostname));
+
+            for (const auto& sid : sids) {
+                std::wstring key = HostCache::MakeKey(sid);
+
+                for (size_t i = 0; i < m_targetKeys.size(); ++i) {
+                    if (key != m_targetKeys[i]) {
+                        continue;
+                    }
+
+                    if (m_locations[i].empty()) {
+                        m_remaining--;
+                    }
+                    m_locations[i].push_back(computer.hostname);
+                    matches.push_back(m_targets[i]);
+                }
+            }
+        }
+
+        if (!matches.empty()) {
+            onMatch(computer, matches);
+        }
+    }
+}
+
+// Checks whether the search is over
+bool UserLocator::ShouldStop() const {
+    return IsComplete() || IsBudgetExhausted();
+}
+
+// Checks the host and time budget
+bool UserLocator::IsBudgetExhausted() const {
+    if (m_budget.maxHosts > 0 && m_hostsProbed.load() >= m_budget.maxHosts) {
+        return true;
+    }
+
+    if (m_budget.maxSeconds > 0 &&
+        std::chrono::duration<double>(Clock::now() - m_startTime).count() >= m_budget.maxSeconds) {
+        return true;
+    }
+
+    return false;
+}
+
+// Returns the hosts on which a target was found
+std::vector<std::wstring> UserLocator::GetLocations(size_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return index < m_locations.size() ? m_locations[index] : std::vector<std::wstring>();
+}
+
+// Returns the naming group of a computer
+std::wstring UserLocator::GetNameGroup(const std::wstring& computerName) {
+    // "ist-ws-0142" and "ist-ws-0917" share the group "ist-ws-"
+    size_t end = computerName.size();
+    while (end > 0 && std::iswdigit(computerName[end - 1])) {
+        end--;
+    }
+    return computerName.substr(0, end);
+}
@@ -0,0 +1,143 @@
+#ifndef USERLOCATOR_H
+#define USERLOCATOR_H
+
+#include "ADHelper.h"
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+class HostCache;
+class ProgressReporter;
+
+/**
+ * @struct LocateBudget
+ * @brief Limits for a targeted search (0 = unlimited)
+ */
+struct LocateBudget {
+    size_t maxHosts = 0;            // Maximum hosts to probe
+    double maxSeconds = 0;          // Maximum wall-clock time
+};
+
+/**
+ * @class UserLocator
+ * @brief Finds the computers on which specific accounts are logged on
+ *
+ * Each probe returns only the HKEY_USERS subkey names of a host, which are
+ * compared against the target SIDs; no SID is resolved per host. Hosts are
+ * probed in order of likelihood and the search stops as soon as every
+ * target has been seen once or the budget is used up.
+ */
+class UserLocator {
+public:
+    /**
+     * @brief Probe that returns the loaded profile SIDs of one computer and the connection result
+     */
+    using SidProbe = std::function<std::vector<std::wstring>(const ComputerInfo&, long& errorCode)>;
+
+    /**
+     * @brief Called once per host on which at least one target was found
+     */
+    using MatchHandler = std::function<void(const ComputerInfo&, const std::vector<UserInfo>&)>;
+
+    /**
+     * @brief Constructs the locator
+     * @param targets Accounts to find (resolved SIDs)
+     * @param budget Search limits
+     */
+    UserLocator(const std::vector<UserInfo>& targets, const LocateBudget& budget);
+
+    /**
+     * @brief Returns the hosts on which a previous scan saw any of the targets
+     * @param history Cache from earlier scans
+     * @param domain Domain name, used to derive short computer names
+     */
+    std::vector<ComputerInfo> GetHistoryCandidates(HostCache& history, const std::wstring& domain);
+
+    /**
+     * @brief Drops already probed hosts and sorts the rest by likelihood
+     *
+     * Hosts where a target was seen before come first, then hosts in the same
+     * naming group (name without its trailing number) as those, then hosts
+     * that answered in a previous scan, then everything else.
+     *
+     * @param computers Hosts to order
+     * @param history Cache from earlier scans (optional)
+     */
+    void OrderByLikelihood(std::vector<ComputerInfo>& computers, HostCache* history);
+
+    /**
+     * @brief Probes the hosts in order until all targets are found or the budget runs out
+     * @param probe Probe function
+     * @param computers Hosts in probe order
+     * @param threadCount Number of threads
+     * @param onMatch Receives each host with its matching targets
+     * @param progressFile JSON-lines progress output ("-" for stderr, empty for none)
+     * @return False if the search could not be started
+     */
+    bool Probe(const SidProbe& probe, const std::vector<ComputerInfo>& computers, int threadCount,
+        const MatchHandler& onMatch, const std::wstring& progressFile);
+
+    /**
+     * @brief Returns true once every target has been found
+     */
+    bool IsComplete() const { return m_remaining.load() == 0; }
+
+    /**
+     * @brief Returns true if the host or time budget is used up
+     */
+    bool IsBudgetExhausted() const;
+
+    /**
+     * @brief Returns the targets
+     */
+    const std::vector<UserInfo>& GetTargets() const { return m_targets; }
+
+    /**
+     * @brief Returns the hosts on which a target was found
+     * @param index Target index
+     */
+    std::vector<std::wstring> GetLocations(size_t index);
+
+    /**
+     * @brief Returns the number of hosts probed so far
+     */
+    size_t GetHostsProbed() const { return m_hostsProbed.load(); }
+
+    /**
+     * @brief Returns the naming group of a computer (short name without trailing digits)
+     */
+    static std::wstring GetNameGroup(const std::wstring& computerName);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<UserInfo> m_targets;                    // Accounts to find
+    std::vector<std::wstring> m_targetKeys;             // Target SIDs, normalized for comparison
+    LocateBudget m_budget;                              // Search limits
+    Clock::time_point m_startTime;                      // Start of the search (time budget)
+
+    std::mutex m_mutex;                                 // Protects the fields below
+    std::vector<std::vector<std::wstring>> m_locations; // Hosts per target
+    std::unordered_set<std::wstring> m_probed;          // Probed hosts (normalized)
+
+    std::atomic<size_t> m_remaining;                    // Targets not found yet
+    std::atomic<size_t> m_hostsProbed;                  // Hosts probed (budget)
+    std::atomic<size_t> m_nextIndex;                    // Next host for a worker
+
+    /**
+     * @brief Worker thread body: takes hosts in order until done
+     */
+    void ProbeLoop(const SidProbe& probe, const std::vector<ComputerInfo>& computers,
+        const MatchHandler& onMatch, ProgressReporter& progress);
+
+    /**
+     * @brief Returns true if workers should stop taking hosts
+     */
+    bool ShouldStop() const;
+};
+
+#endif // USERLOCATOR_H
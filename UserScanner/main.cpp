@@ -1,11 +1,41 @@
 #include "ADHelper.h"
 #include "ReportGenerator.h"
+#include "CompressedWriter.h"
+#include "Benchmark.h"
+#include "ProgressReporter.h"
+#include "HostCache.h"
+#include "UserLocator.h"
+#include "DnsResolver.h"
+#include "ScanCoordinator.h"
+#include "ScanWorker.h"
+#include "HostScheduler.h"
+#include "RetryQueue.h"
+#include "Tracer.h"
+#include "Platform.h"
 #include <iostream>
 #include <vector>
 #include <thread>
 #include <future>
 #include <algorithm>
+#include <functional>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <unordered_set>
+#include <cwctype>
+#ifdef _WIN32
 #include <windows.h>
+#endif
+
+/**
+ * @brief Probe that returns the logged-on users of one computer and the connection result
+ */
+using HostProbe = std::function<std::vector<UserInfo>(const ComputerInfo&, long& errorCode)>;
+
+/**
+ * @brief Receives the result of one computer (index into the scanned list)
+ */
+using ResultSink = std::function<void(size_t index, const ComputerInfo&, long errorCode, const std::vector<UserInfo>&)>;
 
 /**
  * @brief Shows the help message
@@ -20,9 +50,52 @@ void ShowHelp() {
     std::wcout << L"  -o,  --output      Output CSV file (e.g., report.csv)" << std::endl;
     std::wcout << L"\nOptional Parameters:" << std::endl;
     std::wcout << L"  -t,  --threads     Number of threads (default: 100)" << std::endl;
+    std::wcout << L"  -z,  --compress    Write the report as a gzip stream" << std::endl;
+    std::wcout << L"       --level       Compression level 1-9 (default: 6)" << std::endl;
+    std::wcout << L"       --frame-size  Compression block size in KB (default: 1024)" << std::endl;
+    std::wcout << L"       --progress-file  Write JSON-lines progress to a file (- for stderr)" << std::endl;
+    std::wcout << L"       --cache       Host result cache file; unchanged hosts skip SID lookups" << std::endl;
+    std::wcout << L"       --resolve-threads  Concurrent DNS lookups before the scan (default: 64, 0 = off)" << std::endl;
+    std::wcout << L"       --connect-by-address  Connect to the resolved address instead of the name (NTLM)" << std::endl;
+    std::wcout << L"       --subnet-concurrency  Probes in flight per subnet (default: no limit)" << std::endl;
+    std::wcout << L"       --subnet-rate     New connections per second per subnet (default: no limit)" << std::endl;
+    std::wcout << L"       --retries     Retries of hosts with transient failures after the pass (default: 2, 0 = off)" << std::endl;
+    std::wcout << L"       --retry-delay Seconds before the first retry, doubled per retry (default: 5)" << std::endl;
+    std::wcout << L"       --trace       Write per-host and LDAP timing spans to a Chrome trace JSON file" << std::endl;
+    std::wcout << L"       --trace-buffer  Spans kept per thread; older spans are overwritten (default: 65536)" << std::endl;
+    std::wcout << L"       --hosts       Only scan the hosts listed in a file or a previous report (- for stdin)" << std::endl;
     std::wcout << L"  -h,  --help        Show this help message" << std::endl;
+    std::wcout << L"\nFind Mode (-o optional):" << std::endl;
+    std::wcout << L"       --find          Account to locate: SID, DOMAIN\\user or user (repeatable, comma-separated)" << std::endl;
+    std::wcout << L"       --find-budget   Stop after probing this many hosts (default: no limit)" << std::endl;
+    std::wcout << L"       --find-timeout  Stop after this many seconds (default: no limit)" << std::endl;
+    std::wcout << L"\nDistributed Mode:" << std::endl;
+    std::wcout << L"       --coordinator       Listen on [address:]port (port only = loopback), enumerate once and hand hosts to workers" << std::endl;
+    std::wcout << L"       --workers           Number of workers the coordinator waits for (default: 2)" << std::endl;
+    std::wcout << L"       --partition-by-site Keep each naming group (e.g. IST-WS-) on one worker" << std::endl;
+    std::wcout << L"       --worker            Scan the hosts assigned by the coordinator at address:port" << std::endl;
+    std::wcout << L"       --worker-name       Partitioning key of this worker (default: computer name)" << std::endl;
+    std::wcout << L"       --token             Shared secret of coordinator and workers (default: USERSCANNER_TOKEN)" << std::endl;
+    std::wcout << L"                           Frames are authenticated but not encrypted; user names are readable on the wire" << std::endl;
+    std::wcout << L"       --join-timeout      Seconds the coordinator waits for all workers (default: 300)" << std::endl;
+    std::wcout << L"\nBenchmark Mode (no domain required):" << std::endl;
+    std::wcout << L"       --benchmark           Run the full scan against a synthetic directory and fleet" << std::endl;
+    std::wcout << L"       --bench-hosts         Number of synthetic computers (default: 10000)" << std::endl;
+    std::wcout << L"       --bench-latency       Median per-host latency in ms (default: 20)" << std::endl;
+    std::wcout << L"       --bench-failure-rate  Fraction of unreachable hosts (default: 0.10)" << std::endl;
+    std::wcout << L"       --bench-timeout-rate  Fraction of hosts that time out (default: 0.02)" << std::endl;
+    std::wcout << L"       --bench-recovery-rate Fraction of timed-out hosts that answer a retry (default: 0.5)" << std::endl;
+    std::wcout << L"       --bench-sessions      Mean sessions per reachable host (default: 1.5)" << std::endl;
+    std::wcout << L"       --bench-subnets       Spread the hosts over this many /24 subnets (default: 0 = no addresses)" << std::endl;
+    std::wcout << L"       --bench-branch-capacity  Probes the first subnet carries at full speed (default: no limit)" << std::endl;
+    std::wcout << L"       --bench-seed          Seed for the synthetic distributions (default: 1)" << std::endl;
+    std::wcout << L"       --bench-encoding      Only compare CSV row encoding throughput" << std::endl;
     std::wcout << L"\nExample:" << std::endl;
     std::wcout << L"  program.exe -d example.com -dc dc.example.com -o report.csv -t 50" << std::endl;
+    std::wcout << L"  program.exe -d example.com -dc dc.example.com --find jdoe --cache hosts.cache" << std::endl;
+    std::wcout << L"  program.exe -d example.com -dc dc.example.com -o report.csv --coordinator 0.0.0.0:9000 --workers 4" << std::endl;
+    std::wcout << L"  program.exe --worker coordinator.example.com:9000 -t 200" << std::endl;
+    std::wcout << L"  program.exe --benchmark --bench-hosts 50000 -o bench.csv -t 200" << std::endl;
     std::wcout << L"\nNote: The program scans all computers in the domain and saves" << std::endl;
     std::wcout << L"logged-on users in CSV format." << std::endl;
 }
@@ -35,9 +108,51 @@ struct CommandLineArgs {
     std::wstring domainController;
     std::wstring outputFile;
     int threadCount = 100;
+    CompressionOptions compression;
+    std::wstring progressFile;
+    std::wstring cacheFile;
+    std::wstring hostListFile;
+    int resolveThreads = 64;
+    bool connectByAddress = false;
+    SchedulerOptions scheduling;
+    RetryOptions retry;
+    std::wstring traceFile;
+    size_t traceBufferSpans = 65536;
+    std::vector<std::wstring> findAccounts;
+    LocateBudget locateBudget;
+    std::wstring coordinatorEndpoint;
+    int workerCount = 2;
+    bool partitionBySite = false;
+    std::wstring workerEndpoint;
+    std::wstring workerName;
+    std::string token;
+    int joinTimeoutSeconds = 300;
+    bool benchmark = false;
+    bool benchmarkEncoding = false;
+    BenchmarkOptions benchmarkOptions;
     bool valid = false;
 };
 
+/**
+ * @brief Parses a numeric option value, printing an error on failure
+ */
+bool ParseNumber(const char* text, const wchar_t* name, double minValue, double maxValue, double& value) {
+    try {
+        value = std::stod(text);
+    }
+    catch (...) {
+        std::wcerr << L"[ERROR] Invalid value for " << name << L"." << std::endl;
+        return false;
+    }
+
+    if (value < minValue || value > maxValue) {
+        std::wcerr << L"[ERROR] " << name << L" must be between " << minValue
+            << L" and " << maxValue << L"." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 CommandLineArgs ParseArguments(int argc, char* argv[]) {
     CommandLineArgs args;
 
@@ -76,12 +191,228 @@ CommandLineArgs ParseArguments(int argc, char* argv[]) {
                 return args;
             }
         }
+        else if (arg == "-z" || arg == "--compress") {
+            args.compression.enabled = true;
+        }
+        else if (arg == "--level" && i + 1 < argc) {
+            try {
+                args.compression.level = std::stoi(argv[++i]);
+                if (args.compression.level < 1 || args.compression.level > 9) {
+                    std::wcerr << L"[ERROR] Compression level must be between 1 and 9." << std::endl;
+                    return args;
+                }
+            }
+            catch (...) {
+                std::wcerr << L"[ERROR] Invalid compression level." << std::endl;
+                return args;
+            }
+        }
+        else if (arg == "--frame-size" && i + 1 < argc) {
+            try {
+                int frameKB = std::stoi(argv[++i]);
+                if (frameKB < 64) {
+                    frameKB = 64;
+                }
+                else if (frameKB > 65536) {
+                    std::wcout << L"[WARNING] Frame size limited to 65536 KB." << std::endl;
+                    frameKB = 65536;
+                }
+                args.compression.frameSize = static_cast<size_t>(frameKB) * 1024;
+            }
+            catch (...) {
+                std::wcerr << L"[ERROR] Invalid frame size." << std::endl;
+                return args;
+            }
+        }
+        else if (arg == "--progress-file" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.progressFile = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--cache" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.cacheFile = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--hosts" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.hostListFile = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--resolve-threads" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--resolve-threads", 0, 1000, value)) return args;
+            args.resolveThreads = static_cast<int>(value);
+        }
+        else if (arg == "--connect-by-address") {
+            args.connectByAddress = true;
+        }
+        else if (arg == "--subnet-concurrency" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--subnet-concurrency", 0, 10000, value)) return args;
+            args.scheduling.maxInFlight = static_cast<int>(value);
+        }
+        else if (arg == "--subnet-rate" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--subnet-rate", 0, 100000, value)) return args;
+            args.scheduling.connectRate = value;
+        }
+        else if (arg == "--retries" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--retries", 0, 10, value)) return args;
+            args.retry.maxRetries = static_cast<int>(value);
+        }
+        else if (arg == "--retry-delay" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--retry-delay", 0, 3600, value)) return args;
+            args.retry.baseDelaySeconds = value;
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.traceFile = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--trace-buffer" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--trace-buffer", 1, 100000000, value)) return args;
+            args.traceBufferSpans = static_cast<size_t>(value);
+        }
+        else if (arg == "--find" && i + 1 < argc) {
+            std::string value = argv[++i];
+            std::wstring accounts(value.begin(), value.end());
+
+            size_t start = 0;
+            while (start <= accounts.size()) {
+                size_t pos = accounts.find(L',', start);
+                std::wstring account = accounts.substr(start, pos == std::wstring::npos ? std::wstring::npos : pos - start);
+                if (!account.empty()) {
+                    args.findAccounts.push_back(account);
+                }
+                if (pos == std::wstring::npos) {
+                    break;
+                }
+                start = pos + 1;
+            }
+        }
+        else if (arg == "--find-budget" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--find-budget", 1, 10000000, value)) return args;
+            args.locateBudget.maxHosts = static_cast<size_t>(value);
+        }
+        else if (arg == "--find-timeout" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--find-timeout", 0.1, 86400, value)) return args;
+            args.locateBudget.maxSeconds = value;
+        }
+        else if (arg == "--coordinator" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.coordinatorEndpoint = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--workers" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--workers", 1, 1000, value)) return args;
+            args.workerCount = static_cast<int>(value);
+        }
+        else if (arg == "--partition-by-site") {
+            args.partitionBySite = true;
+        }
+        else if (arg == "--worker" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.workerEndpoint = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--worker-name" && i + 1 < argc) {
+            std::string value = argv[++i];
+            args.workerName = std::wstring(value.begin(), value.end());
+        }
+        else if (arg == "--token" && i + 1 < argc) {
+            args.token = argv[++i];
+        }
+        else if (arg == "--join-timeout" && i + 1 < argc) {
+            double value = 0;
+            if (!ParseNumber(argv[++i], L"--join-timeout", 1, 86400, value)) return args;
+            args.joinTimeoutSeconds = static_cast<int>(value);
+        }
+        else if (arg == "--benchmark") {
+            args.benchmark = true;
+        }
+        else if (arg == "--bench-encoding") {
+            args.benchmark = true;
+            args.benchmarkEncoding = true;
+        }
+        else if (arg.compare(0, 8, "--bench-") == 0 && i + 1 < argc) {
+            BenchmarkOptions& bench = args.benchmarkOptions;
+            std::wstring name(arg.begin(), arg.end());
+            double value = 0;
+
+            if (arg == "--bench-hosts") {
+                if (!ParseNumber(argv[++i], name.c_str(), 1, 10000000, value)) return args;
+                bench.hostCount = static_cast<size_t>(value);
+            }
+            else if (arg == "--bench-latency") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 60000, value)) return args;
+                bench.latencyMs = static_cast<int>(value);
+            }
+            else if (arg == "--bench-failure-rate") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 1, value)) return args;
+                bench.failureRate = value;
+            }
+            else if (arg == "--bench-timeout-rate") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 1, value)) return args;
+                bench.timeoutRate = value;
+            }
+            else if (arg == "--bench-recovery-rate") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 1, value)) return args;
+                bench.recoveryRate = value;
+            }
+            else if (arg == "--bench-sessions") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 100, value)) return args;
+                bench.sessionMean = value;
+            }
+            else if (arg == "--bench-subnets") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 65536, value)) return args;
+                bench.subnetCount = static_cast<size_t>(value);
+            }
+            else if (arg == "--bench-branch-capacity") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 10000, value)) return args;
+                bench.branchCapacity = static_cast<int>(value);
+            }
+            else if (arg == "--bench-seed") {
+                if (!ParseNumber(argv[++i], name.c_str(), 0, 4294967295.0, value)) return args;
+                bench.seed = static_cast<unsigned int>(value);
+            }
+            else {
+                std::wcerr << L"[ERROR] Unknown parameter: " << name << std::endl;
+                return args;
+            }
+        }
         else {
             std::wcerr << L"[ERROR] Unknown parameter: " << std::wstring(arg.begin(), arg.end()) << std::endl;
             return args;
         }
     }
 
+    // Coordinator and workers only talk to peers that know the shared secret
+    if (!args.workerEndpoint.empty() || !args.coordinatorEndpoint.empty()) {
+        if (args.token.empty()) {
+            args.token = GetEnvironmentValue(L"USERSCANNER_TOKEN");
+        }
+        if (args.token.empty()) {
+            std::wcerr << L"[ERROR] Distributed mode requires a shared secret (--token or USERSCANNER_TOKEN)" << std::endl;
+            return args;
+        }
+    }
+
+    // Workers get the domain and their hosts from the coordinator
+    if (!args.workerEndpoint.empty()) {
+        args.valid = true;
+        return args;
+    }
+
+    // Benchmark mode generates its own directory
+    if (args.benchmark) {
+        if (args.outputFile.empty()) {
+            args.outputFile = L"benchmark.csv";
+        }
+        args.valid = true;
+        return args;
+    }
+
     // Check required parameters
     if (args.domain.empty()) {
         std::wcerr << L"[ERROR] Domain name not specified (-d or --domain)" << std::endl;
@@ -91,7 +422,7 @@ CommandLineArgs ParseArguments(int argc, char* argv[]) {
         std::wcerr << L"[ERROR] Domain controller not specified (-dc or --dc)" << std::endl;
         return args;
     }
-    if (args.outputFile.empty()) {
+    if (args.outputFile.empty() && args.findAccounts.empty()) {
         std::wcerr << L"[ERROR] Output file not specified (-o or --output)" << std::endl;
         return args;
     }
@@ -101,37 +432,619 @@ CommandLineArgs ParseArguments(int argc, char* argv[]) {
 }
 
 /**
- * @brief Processes a batch of computers
+ * @brief Reads host names from a list or a previous report (first CSV column)
+ * @param path File path, or "-" for stdin
+ * @param hosts Receives the unique host names in input order
+ * @return True if successful
  */
-void ProcessComputerBatch(ADHelper& adHelper,
-    ReportGenerator& reportGen,
+bool ReadHostList(const std::wstring& path, std::vector<std::wstring>& hosts) {
+    std::ifstream file;
+    if (path != L"-") {
+        file.open(ToNativePath(path));
+        if (!file.is_open()) {
+            std::wcerr << L"[ERROR] Could not open host list: " << path << std::endl;
+            return false;
+        }
+    }
+    std::istream& input = (path == L"-") ? std::cin : file;
+
+    std::unordered_set<std::wstring> seen;
+    std::string rawLine;
+    bool firstLine = true;
+
+    while (std::getline(input, rawLine)) {
+        if (firstLine && rawLine.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            rawLine.erase(0, 3);
+        }
+        firstLine = false;
+
+        std::wstring line = UTF8ToWide(rawLine);
+
+        // Keep the first field; whitespace also separates names in plain lists
+        size_t end = line.find_first_of(L",;\t\r ");
+        std::wstring name = line.substr(0, end);
+        if (name.size() >= 2 && name.front() == L'"' && name.back() == L'"') {
+            name = name.substr(1, name.size() - 2);
+        }
+
+        // Skip blank lines, comments and the report header
+        if (name.empty() || name[0] == L'#' || name == L"Computer") {
+            continue;
+        }
+
+        std::wstring key = name;
+        for (auto& ch : key) {
+            ch = static_cast<wchar_t>(std::towlower(ch));
+        }
+        if (seen.insert(key).second) {
+            hosts.push_back(name);
+        }
+    }
+
+    std::wcout << L"[INFO] " << hosts.size() << L" hosts read from " << (path == L"-" ? L"stdin" : path) << std::endl;
+    return true;
+}
+
+/**
+ * @brief Retrieves the computers to scan: the listed hosts if a host list is given, otherwise all
+ * @return False if the host list could not be read
+ */
+bool LoadComputers(const CommandLineArgs& args, ADHelper& adHelper, std::vector<ComputerInfo>& computers) {
+    if (args.hostListFile.empty()) {
+        computers = adHelper.GetAllComputers();
+        return true;
+    }
+
+    std::vector<std::wstring> hosts;
+    if (!ReadHostList(args.hostListFile, hosts)) {
+        return false;
+    }
+
+    std::vector<std::wstring> notFound;
+    computers = adHelper.GetComputers(hosts, &notFound);
+
+    if (!notFound.empty()) {
+        std::wcout << L"[WARNING] " << notFound.size() << L" listed hosts are not in the directory:";
+        for (size_t i = 0; i < notFound.size() && i < 10; ++i) {
+            std::wcout << L" " << notFound[i];
+        }
+        std::wcout << (notFound.size() > 10 ? L" ..." : L"") << std::endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns a probe that reads the logged-on users from the remote registry
+ *
+ * Connects by name, so the connection authenticates with Kerberos; the
+ * pre-resolved address is used only with --connect-by-address.
+ */
+HostProbe RegistryProbe(ADHelper& adHelper, bool connectByAddress) {
+    return [&adHelper, connectByAddress](const ComputerInfo& computer, long& errorCode) {
+        static const std::wstring byName;
+        return adHelper.GetLoggedOnUsers(computer.hostname, &errorCode, connectByAddress ? computer.address : byName);
+    };
+}
+
+/**
+ * @brief Returns a sink that writes each result to the report
+ */
+ResultSink ReportSink(ReportGenerator& reportGen) {
+    return [&reportGen](size_t, const ComputerInfo& computer, long errorCode, const std::vector<UserInfo>& users) {
+        reportGen.AddEntry(computer, users, ClassifyProbeError(errorCode));
+    };
+}
+
+/**
+ * @brief Probes one host; names that do not resolve are not probed
+ */
+std::vector<UserInfo> ProbeHost(const HostProbe& probe, const ComputerInfo& computer, long& errorCode) {
+    TraceSpan span("host", "scan", computer.hostname);
+
+    if (computer.nameNotFound) {
+        errorCode = DnsResolver::kHostNotFound;
+        return std::vector<UserInfo>();
+    }
+
+    errorCode = 0;
+    return probe(computer, errorCode);
+}
+
+/**
+ * @brief Probes the hosts handed out by the scheduler until none are left
+ */
+void ProcessComputerBatch(const HostProbe& probe,
+    const ResultSink& sink,
+    ProgressReporter& progress,
     const std::vector<ComputerInfo>& computers,
-    size_t startIdx,
-    size_t endIdx) {
-    for (size_t i = startIdx; i < endIdx; ++i) {
+    HostScheduler& scheduler,
+    RetryQueue& retries) {
+    size_t i = 0;
+    while (scheduler.Next(i)) {
         const auto& computer = computers[i];
 
         // Get user information
-        auto users = adHelper.GetLoggedOnUsers(computer.hostname);
+        long errorCode = 0;
+        std::vector<UserInfo> users = ProbeHost(probe, computer, errorCode);
+
+        // The segment slot is free once the connection is done
+        scheduler.Finished(i);
+
+        // Transient failures are retried after the pass instead of holding up this thread
+        if (IsTransient(ClassifyProbeError(errorCode)) && retries.Defer(i, 1)) {
+            continue;
+        }
 
         // Add to report
-        reportGen.AddEntry(computer, users);
+        {
+            TraceSpan span("report", "scan", computer.hostname);
+            sink(i, computer, errorCode, users);
+        }
+
+        // Progress is printed by the reporter thread
+        progress.RecordHost(ProgressReporter::Classify(errorCode));
+    }
+}
+
+/**
+ * @brief Retries deferred hosts as they become due until none are left
+ */
+void ProcessRetries(const HostProbe& probe,
+    const ResultSink& sink,
+    ProgressReporter& progress,
+    const std::vector<ComputerInfo>& computers,
+    HostScheduler& scheduler,
+    RetryQueue& retries) {
+    size_t i = 0;
+    int failures = 0;
+    while (retries.Next(i, failures)) {
+        const auto& computer = computers[i];
+
+        // Retries count against the same subnet limits as the main pass
+        scheduler.Acquire(i);
+        long errorCode = 0;
+        std::vector<UserInfo> users = ProbeHost(probe, computer, errorCode);
+        scheduler.Finished(i);
+
+        // Still failing: back off further, or report the last failure once the retries are used up
+        if (!IsTransient(ClassifyProbeError(errorCode)) || !retries.Defer(i, failures + 1)) {
+            TraceSpan span("report", "scan", computer.hostname);
+            sink(i, computer, errorCode, users);
+            progress.RecordHost(ProgressReporter::Classify(errorCode));
+        }
+
+        retries.Finished(errorCode == 0);
+    }
+}
+
+/**
+ * @brief Runs the scan threads over the computers and waits for all of them
+ *
+ * Finished hosts are counted on a reporter the caller has started, so a
+ * scan that follows another phase continues its progress.
+ */
+void ScanComputers(const HostProbe& probe,
+    const ResultSink& sink,
+    const std::vector<ComputerInfo>& computers,
+    int threadCount,
+    const SchedulerOptions& scheduling,
+    const RetryOptions& retryOptions,
+    ProgressReporter& progress) {
+    // Threads pull hosts round-robin across subnets instead of owning a fixed slice
+    HostScheduler scheduler(computers, scheduling);
+    if (scheduler.GetGroupCount() > 1) {
+        std::wcout << L"[INFO] Interleaving " << computers.size() << L" hosts across "
+            << scheduler.GetGroupCount() << L" subnets" << std::endl;
+    }
+    RetryQueue retries(retryOptions);
+
+    int workerCount = static_cast<int>(std::min<size_t>(threadCount, computers.size()));
+    std::vector<std::future<void>> futures;
+
+    for (int t = 0; t < workerCount; ++t) {
+        // Launch thread
+        futures.push_back(std::async(std::launch::async,
+            ProcessComputerBatch,
+            std::cref(probe),
+            std::cref(sink),
+            std::ref(progress),
+            std::cref(computers),
+            std::ref(scheduler),
+            std::ref(retries)));
+    }
+
+    // Wait for all threads to finish
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    // Hosts with transient failures get their retries once the main pass is done;
+    // they are still open in the progress counts
+    size_t deferred = retries.GetDeferredHosts();
+    if (deferred > 0) {
+        std::wcout << L"\n[INFO] Retrying " << deferred << L" hosts with transient failures..." << std::endl;
+
+        futures.clear();
+        workerCount = static_cast<int>(std::min<size_t>(threadCount, deferred));
+        for (int t = 0; t < workerCount; ++t) {
+            futures.push_back(std::async(std::launch::async,
+                ProcessRetries,
+                std::cref(probe),
+                std::cref(sink),
+                std::ref(progress),
+                std::cref(computers),
+                std::ref(scheduler),
+                std::ref(retries)));
+        }
+
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
+
+    if (deferred > 0) {
+        std::wcout << L"\n[INFO] Retries: " << retries.GetRecoveredHosts() << L" of " << deferred
+            << L" hosts answered" << std::endl;
+    }
+}
+
+/**
+ * @brief Runs the scan threads over the computers with their own progress reporter
+ * @return False if the scan could not be started
+ */
+bool ScanComputers(const HostProbe& probe,
+    const ResultSink& sink,
+    const std::vector<ComputerInfo>& computers,
+    int threadCount,
+    const SchedulerOptions& scheduling,
+    const RetryOptions& retryOptions,
+    const std::wstring& progressFile) {
+    ProgressReporter progress(computers.size(), progressFile);
+    if (!progress.Start()) {
+        return false;
+    }
+
+    ScanComputers(probe, sink, computers, threadCount, scheduling, retryOptions, progress);
+    progress.Stop();
+    return true;
+}
+
+/**
+ * @brief Runs enumeration, probing, resolution and reporting against synthetic fixtures
+ */
+int RunBenchmark(const CommandLineArgs& args) {
+    using Clock = std::chrono::steady_clock;
+    const BenchmarkOptions& options = args.benchmarkOptions;
+
+    if (args.benchmarkEncoding) {
+        return RunEncodingBenchmark(options.hostCount * 100) ? 0 : 1;
+    }
+
+    std::wcout << L"[INFO] Benchmark: " << options.hostCount << L" hosts, "
+        << options.latencyMs << L" ms median latency, "
+        << options.failureRate << L" failure rate, "
+        << options.timeoutRate << L" timeout rate, "
+        << options.sessionMean << L" sessions/host" << std::endl;
+
+    ReportGenerator reportGen(args.outputFile, args.compression);
+    if (!reportGen.Initialize()) {
+        return 1;
+    }
+
+    // Enumeration: the ADHelper search against the synthetic directory
+    auto enumStart = Clock::now();
+    std::vector<ComputerInfo> computers = EnumerateSyntheticDirectory(options);
+    double enumSeconds = std::chrono::duration<double>(Clock::now() - enumStart).count();
+
+    // Probing, resolution and reporting through the normal scan path
+    SimulatedFleet fleet(options);
+    LatencyRecorder latencies;
+    HostProbe probe = [&fleet, &latencies](const ComputerInfo& computer, long& errorCode) {
+        auto start = Clock::now();
+        auto users = fleet.GetLoggedOnUsers(computer, &errorCode);
+        latencies.Record(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        return users;
+    };
+
+    auto scanStart = Clock::now();
+    if (!ScanComputers(probe, ReportSink(reportGen), computers, args.threadCount, args.scheduling, args.retry, args.progressFile)) {
+        return 1;
+    }
+    uint64_t bytesWritten = reportGen.GetBytesWritten();
+    reportGen.Close();
+    double scanSeconds = std::chrono::duration<double>(Clock::now() - scanStart).count();
+
+    const double mb = 1024.0 * 1024.0;
+    std::wcout << L"\n=== BENCHMARK RESULTS ===" << std::endl;
+    std::wcout << L"Hosts: " << computers.size() << std::endl;
+    std::wcout << L"Enumeration: " << (enumSeconds > 0 ? computers.size() / enumSeconds : 0.0) << L" hosts/sec" << std::endl;
+
+    // Each host counts once; retries show up in the attempts only
+    std::wcout << L"Scan: " << scanSeconds << L" s, "
+        << (scanSeconds > 0 ? computers.size() / scanSeconds : 0.0) << L" hosts/sec" << std::endl;
+    std::wcout << L"Probe attempts: " << latencies.GetCount() << L", "
+        << (scanSeconds > 0 ? latencies.GetCount() / scanSeconds : 0.0) << L" attempts/sec" << std::endl;
+    std::wcout << L"Per-host latency: p50 " << latencies.Percentile(50) << L" ms, p99 "
+        << latencies.Percentile(99) << L" ms" << std::endl;
+    std::wcout << L"Peak RSS: " << (GetPeakMemoryUsage() / mb) << L" MB" << std::endl;
+    std::wcout << L"Report output: " << (bytesWritten / mb) << L" MB, "
+        << (scanSeconds > 0 ? bytesWritten / mb / scanSeconds : 0.0) << L" MB/s" << std::endl;
+
+    return 0;
+}
+
+/**
+ * @brief Locates the requested accounts, probing likely hosts first
+ * @return 0 if every account was found, 2 if some were not, 1 on error
+ */
+int RunFind(const CommandLineArgs& args) {
+    using Clock = std::chrono::steady_clock;
+    auto startTime = Clock::now();
+
+    ADHelper adHelper(args.domain, args.domainController);
+
+    // Names are resolved once, against the domain controller
+    std::vector<UserInfo> targets;
+    for (const auto& account : args.findAccounts) {
+        UserInfo target;
+        if (!adHelper.ResolveAccount(account, target)) {
+            return 1;
+        }
+        std::wcout << L"[INFO] Target: " << target.GetFullName() << L" (" << target.sid << L")" << std::endl;
+        targets.push_back(target);
+    }
+
+    // Results of previous scans decide the probe order
+    std::unique_ptr<HostCache> history;
+    if (!args.cacheFile.empty()) {
+        history = std::make_unique<HostCache>(args.cacheFile);
+        history->Load();
+    }
 
-        // Show progress
-        if ((i - startIdx + 1) % 10 == 0 || i == endIdx - 1) {
-            std::wcout << L"[Thread " << std::this_thread::get_id() << L"] "
-                << (i - startIdx + 1) << L"/" << (endIdx - startIdx)
-                << L" computers processed" << std::endl;
+    std::unique_ptr<ReportGenerator> reportGen;
+    if (!args.outputFile.empty()) {
+        reportGen = std::make_unique<ReportGenerator>(args.outputFile, args.compression);
+        if (!reportGen->Initialize()) {
+            return 1;
+        }
+    }
+
+    // Names are resolved up front, once per run
+    std::unique_ptr<DnsResolver> resolver;
+    if (args.resolveThreads > 0) {
+        resolver = std::make_unique<DnsResolver>(args.resolveThreads);
+    }
+
+    UserLocator locator(targets, args.locateBudget);
+    UserLocator::SidProbe probe = [&adHelper, &args](const ComputerInfo& computer, long& errorCode) {
+        return adHelper.GetLoadedProfileSids(args.connectByAddress ? computer.GetConnectName() : computer.hostname,
+            &errorCode);
+    };
+    UserLocator::MatchHandler onMatch = [&adHelper, &reportGen](const ComputerInfo& computer,
+        const std::vector<UserInfo>& users) {
+        if (!reportGen) {
+            return;
+        }
+
+        // History candidates are not enumerated, so their OS is only looked up on a match
+        ComputerInfo info = computer;
+        if (info.operatingSystem.empty()) {
+            info.operatingSystem = adHelper.GetComputerOS(info.computerName);
+        }
+        reportGen->AddEntry(info, users);
+    };
+
+    // Hosts where a target was seen before can answer without enumerating the domain
+    // (with a host list they are only moved to the front of that list)
+    if (history && args.hostListFile.empty()) {
+        auto candidates = locator.GetHistoryCandidates(*history, args.domain);
+        if (!candidates.empty()) {
+            if (resolver) {
+                resolver->ResolveAll(candidates);
+            }
+            std::wcout << L"\n[INFO] Probing " << candidates.size() << L" hosts from previous results..." << std::endl;
+            if (!locator.Probe(probe, candidates, args.threadCount, onMatch, args.progressFile)) {
+                return 1;
+            }
         }
     }
+
+    if (!locator.IsComplete() && !locator.IsBudgetExhausted()) {
+        std::wcout << L"[INFO] Scanning computers..." << std::endl;
+        std::vector<ComputerInfo> computers;
+        if (!LoadComputers(args, adHelper, computers)) {
+            return 1;
+        }
+        locator.OrderByLikelihood(computers, history.get());
+        if (resolver) {
+            resolver->ResolveAll(computers);
+        }
+
+        std::wcout << L"\n[INFO] Probing up to " << computers.size() << L" remaining hosts..." << std::endl;
+        if (!locator.Probe(probe, computers, args.threadCount, onMatch, args.progressFile)) {
+            return 1;
+        }
+    }
+
+    if (reportGen) {
+        reportGen->Close();
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    std::wcout << L"\n=== FIND RESULTS ===" << std::endl;
+    for (size_t i = 0; i < locator.GetTargets().size(); ++i) {
+        const UserInfo& target = locator.GetTargets()[i];
+        auto locations = locator.GetLocations(i);
+
+        std::wcout << target.GetFullName() << L": ";
+        if (locations.empty()) {
+            std::wcout << L"not found" << std::endl;
+            continue;
+        }
+        for (size_t j = 0; j < locations.size(); ++j) {
+            std::wcout << (j > 0 ? L", " : L"") << locations[j];
+        }
+        std::wcout << std::endl;
+    }
+    std::wcout << L"Hosts probed: " << locator.GetHostsProbed() << L" in " << seconds << L" s" << std::endl;
+
+    if (!locator.IsComplete()) {
+        if (locator.IsBudgetExhausted()) {
+            std::wcout << L"[WARNING] Search budget exhausted before every account was found." << std::endl;
+        }
+        return 2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Enumerates once, distributes the hosts to the workers and merges their results
+ */
+int RunCoordinator(const CommandLineArgs& args) {
+    using Clock = std::chrono::steady_clock;
+    auto startTime = Clock::now();
+
+    ReportGenerator reportGen(args.outputFile, args.compression);
+    if (!reportGen.Initialize()) {
+        return 1;
+    }
+
+    // The directory is enumerated here only; workers never query it
+    std::vector<ComputerInfo> computers;
+    std::unique_ptr<ADHelper> adHelper;
+    if (args.benchmark) {
+        computers = EnumerateSyntheticDirectory(args.benchmarkOptions);
+    }
+    else {
+        adHelper = std::make_unique<ADHelper>(args.domain, args.domainController);
+        std::wcout << L"[INFO] Scanning computers..." << std::endl;
+        if (!LoadComputers(args, *adHelper, computers)) {
+            return 1;
+        }
+    }
+
+    // Workers are still accepted and sent an empty assignment, so they exit cleanly instead of timing out
+    if (computers.empty()) {
+        std::wcout << L"[WARNING] No computers found." << std::endl;
+    }
+
+    ScanCoordinator coordinator(args.coordinatorEndpoint, args.workerCount, args.partitionBySite, args.token);
+    if (!coordinator.AcceptWorkers(args.joinTimeoutSeconds)) {
+        return 1;
+    }
+
+    // A failed send leaves those hosts unfinished; they are rescanned below
+    coordinator.Distribute(args.domain, args.domainController, computers);
+
+    std::wcout << L"\n[INFO] Collecting user information from workers..." << std::endl;
+    ProgressReporter progress(computers.size(), args.progressFile);
+    if (!progress.Start()) {
+        return 1;
+    }
+    coordinator.CollectResults([&reportGen, &progress](const ComputerInfo& computer, long errorCode,
+        const std::vector<UserInfo>& users) {
+        reportGen.AddEntry(computer, users, ClassifyProbeError(errorCode));
+        progress.RecordHost(ProgressReporter::Classify(errorCode));
+    });
+
+    // Hosts of workers that dropped out are scanned by the coordinator itself, on the same progress counts
+    auto unfinished = coordinator.GetUnfinished();
+    if (!unfinished.empty()) {
+        std::wcout << L"[WARNING] Rescanning " << unfinished.size() << L" hosts of failed workers locally..." << std::endl;
+
+        std::unique_ptr<SimulatedFleet> fleet;
+        HostProbe probe;
+        if (args.benchmark) {
+            fleet = std::make_unique<SimulatedFleet>(args.benchmarkOptions);
+            probe = [&fleet](const ComputerInfo& computer, long& errorCode) {
+                return fleet->GetLoggedOnUsers(computer, &errorCode);
+            };
+        }
+        else {
+            if (args.resolveThreads > 0) {
+                DnsResolver resolver(args.resolveThreads);
+                resolver.ResolveAll(unfinished);
+            }
+            probe = RegistryProbe(*adHelper, args.connectByAddress);
+        }
+
+        ScanComputers(probe, ReportSink(reportGen), unfinished, args.threadCount, args.scheduling, args.retry, progress);
+    }
+    progress.Stop();
+
+    std::wcout << L"\n[SUCCESS] Operation completed!" << std::endl;
+    reportGen.Close();
+    coordinator.PrintSummary();
+    std::wcout << L"Total time: " << std::chrono::duration<double>(Clock::now() - startTime).count()
+        << L" s" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Scans the hosts assigned by a coordinator and streams the results back
+ */
+int RunWorker(const CommandLineArgs& args) {
+    ScanWorker worker(args.workerEndpoint, args.workerName, args.token);
+    ScanAssignment assignment;
+    if (!worker.Connect(assignment)) {
+        return 1;
+    }
+
+    std::unique_ptr<SimulatedFleet> fleet;
+    std::unique_ptr<ADHelper> adHelper;
+    std::unique_ptr<HostCache> hostCache;
+    HostProbe probe;
+
+    if (args.benchmark) {
+        fleet = std::make_unique<SimulatedFleet>(args.benchmarkOptions);
+        probe = [&fleet](const ComputerInfo& computer, long& errorCode) {
+            return fleet->GetLoggedOnUsers(computer, &errorCode);
+        };
+    }
+    else {
+        adHelper = std::make_unique<ADHelper>(assignment.domain, assignment.domainController);
+
+        // A worker keeps its own cache; consistent hashing keeps its hosts stable between runs
+        if (!args.cacheFile.empty()) {
+            hostCache = std::make_unique<HostCache>(args.cacheFile);
+            hostCache->Load();
+            adHelper->SetHostCache(hostCache.get());
+        }
+
+        if (args.resolveThreads > 0) {
+            DnsResolver resolver(args.resolveThreads);
+            resolver.ResolveAll(assignment.computers);
+        }
+
+        probe = RegistryProbe(*adHelper, args.connectByAddress);
+    }
+
+    ResultSink sink = [&worker](size_t index, const ComputerInfo&, long errorCode, const std::vector<UserInfo>& users) {
+        worker.AddResult(index, errorCode, users);
+    };
+    if (!ScanComputers(probe, sink, assignment.computers, args.threadCount, args.scheduling, args.retry, args.progressFile)) {
+        return 1;
+    }
+
+    bool delivered = worker.Finish();
+
+    if (hostCache) {
+        hostCache->Save();
+    }
+
+    return delivered ? 0 : 1;
 }
 
 /**
  * @brief Main program
  */
 int main(int argc, char* argv[]) {
+#ifdef _WIN32
     // Windows console UTF-8 support
     SetConsoleOutputCP(CP_UTF8);
+#endif
     std::wcout.imbue(std::locale(""));
 
     std::wcout << L"\n??????????????????????????????????????????????" << std::endl;
@@ -145,66 +1058,114 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Spans are written when main returns, whichever mode ran
+    std::unique_ptr<Tracer> tracer;
+    if (!args.traceFile.empty()) {
+        tracer = std::make_unique<Tracer>(args.traceFile, args.traceBufferSpans);
+        if (!tracer->Start()) {
+            return 1;
+        }
+    }
+
+    if (!args.workerEndpoint.empty() || !args.coordinatorEndpoint.empty()) {
+        try {
+            return args.workerEndpoint.empty() ? RunCoordinator(args) : RunWorker(args);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] Exception: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (args.benchmark) {
+        try {
+            return RunBenchmark(args);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] Exception: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     std::wcout << L"[INFO] Settings:" << std::endl;
     std::wcout << L"  Domain: " << args.domain << std::endl;
     std::wcout << L"  DC: " << args.domainController << std::endl;
     std::wcout << L"  Output: " << args.outputFile << std::endl;
     std::wcout << L"  Thread Count: " << args.threadCount << std::endl;
+    if (args.compression.enabled) {
+        std::wcout << L"  Compression: gzip level " << args.compression.level
+            << L", " << (args.compression.frameSize / 1024) << L" KB frames" << std::endl;
+    }
     std::wcout << std::endl;
 
+    if (!args.findAccounts.empty()) {
+        try {
+            return RunFind(args);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[ERROR] Exception: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     try {
         // Initialize Active Directory helper
         ADHelper adHelper(args.domain, args.domainController);
 
+        // Results of the previous scan, if requested
+        std::unique_ptr<HostCache> hostCache;
+        if (!args.cacheFile.empty()) {
+            hostCache = std::make_unique<HostCache>(args.cacheFile);
+            hostCache->Load();
+            adHelper.SetHostCache(hostCache.get());
+        }
+
         // Initialize report generator
-        ReportGenerator reportGen(args.outputFile);
+        ReportGenerator reportGen(args.outputFile, args.compression);
         if (!reportGen.Initialize()) {
             return 1;
         }
 
         // Get all computers
         std::wcout << L"[INFO] Scanning computers..." << std::endl;
-        auto computers = adHelper.GetAllComputers();
+        std::vector<ComputerInfo> computers;
+        if (!LoadComputers(args, adHelper, computers)) {
+            return 1;
+        }
 
         if (computers.empty()) {
             std::wcout << L"[WARNING] No computers found." << std::endl;
             return 0;
         }
 
+        // Resolve every name before the scan so stale records cost nothing per host
+        if (args.resolveThreads > 0) {
+            DnsResolver resolver(args.resolveThreads);
+            resolver.ResolveAll(computers);
+        }
+
         std::wcout << L"\n[INFO] Collecting user information..." << std::endl;
 
-        // Divide computers among threads
-        size_t totalComputers = computers.size();
-        size_t computersPerThread = (totalComputers + args.threadCount - 1) / args.threadCount;
+        HostProbe probe = RegistryProbe(adHelper, args.connectByAddress);
+        if (!ScanComputers(probe, ReportSink(reportGen), computers, args.threadCount, args.scheduling, args.retry, args.progressFile)) {
+            return 1;
+        }
 
-        std::vector<std::future<void>> futures;
+        std::wcout << L"\n[SUCCESS] Operation completed!" << std::endl;
+        reportGen.Close();
 
-        for (int t = 0; t < args.threadCount; ++t) {
-            size_t startIdx = t * computersPerThread;
-            size_t endIdx = std::min<size_t>(startIdx + computersPerThread, totalComputers);
+        if (hostCache) {
+            std::wcout << L"Host cache: " << hostCache->GetHits() << L" unchanged, "
+                << hostCache->GetMisses() << L" rescanned";
 
-            if (startIdx >= totalComputers) {
-                break;
+            // Only a full enumeration tells which hosts are gone from the directory
+            if (args.hostListFile.empty()) {
+                std::wcout << L", " << hostCache->Prune(computers) << L" removed";
             }
-
-            // Launch thread
-            futures.push_back(std::async(std::launch::async,
-                ProcessComputerBatch,
-                std::ref(adHelper),
-                std::ref(reportGen),
-                std::cref(computers),
-                startIdx,
-                endIdx));
-        }
-
-        // Wait for all threads to finish
-        for (auto& future : futures) {
-            future.wait();
+            std::wcout << std::endl;
+            hostCache->Save();
         }
 
-        std::wcout << L"\n[SUCCESS] Operation completed!" << std::endl;
-        reportGen.Close();
-
     }
     catch (const std::exception& e) {
         std::cerr << "[ERROR] Exception: " << e.what() << std::endl;